@@ -0,0 +1,128 @@
+/*
+ * File: BookBuilder.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Opening book builder - collects the first moves of every game of a PGN file into a binary opening
+ *              book, and lists the book moves of a position.
+ */
+
+#include "Classes.h"
+#include "Helpers.h"
+#include "MappedFile.h"
+#include "OpeningBook.h"
+#include "PGN.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+using namespace std;
+
+// Replay the main line of every game of the file, adding its first moves to the book
+int buildBook(const char* pgnPath, const char* bookPath, int maxPlies, uint32_t minWeight) {
+    MappedFile file;
+    if (!file.open(pgnPath)) {
+        cout << "Cannot map " << pgnPath << endl;
+        return 1;
+    }
+    auto startTime = chrono::steady_clock::now();
+    OpeningBookBuilder builder;
+    Board board;
+    bool gameOver = false, skipGame = false;
+    int ply = 0;
+    long long games = 1, skipped = 0;
+
+    // A tag or move after the end of a game starts the next one
+    PGNTokenizer tokenizer(file.text());
+    for (PGNToken token = tokenizer.next(); token.type != PGNTokenType::End; token = tokenizer.next()) {
+        if (gameOver && (token.type == PGNTokenType::Tag || token.type == PGNTokenType::Move)) {
+            board.fromFEN(StartFEN);
+            gameOver = skipGame = false;
+            ply = 0;
+            games++;
+        }
+        if (token.type == PGNTokenType::Result) {
+            gameOver = true;
+        }
+        else if (token.type == PGNTokenType::Tag && token.text == "FEN") {
+            skipGame = !board.fromFEN(token.value);
+        }
+        else if (token.type == PGNTokenType::Move && !tokenizer.inVariation() && !skipGame && ply < maxPlies) {
+            Move move;
+            if (!parseSAN(board, token.text, move)) {
+                skipGame = true; // The rest of the game cannot be replayed
+                skipped++;
+                continue;
+            }
+            builder.add(board, move);
+            board.makeMove(move);
+            ply++;
+        }
+    }
+
+    size_t moves = builder.movesAdded();
+    long long entries = builder.write(bookPath, minWeight);
+    if (entries < 0) {
+        cout << "Cannot write " << bookPath << endl;
+        return 1;
+    }
+    cout << games << " games (" << skipped << " with an illegal move), " << moves << " moves, " << entries
+        << " book entries written to " << bookPath << " in "
+        << chrono::duration<double>(chrono::steady_clock::now() - startTime).count() << " s" << endl;
+    return 0;
+}
+
+// List the book moves of a position, most played first
+int probeBook(const char* bookPath, const string& fen) {
+    OpeningBook book;
+    if (!book.open(bookPath)) {
+        cout << "Cannot open the book " << bookPath << endl;
+        return 1;
+    }
+    Board board;
+    if (!board.fromFEN(fen)) {
+        cout << "Invalid FEN " << fen << endl;
+        return 1;
+    }
+    BookMove moves[MaxMoves];
+    int found = book.findMoves(board, moves, MaxMoves);
+    if (found == 0) {
+        cout << "Not in the book (" << book.entryCount() << " entries)" << endl;
+        return 1;
+    }
+    for (int i = 0; i < found; i++) {
+        cout << moveToString(moves[i].move) << " " << moves[i].weight << endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "Usage: BookBuilder <games.pgn> <book.bin> [plies <n>] [min <n>]" << endl;
+        cout << "       BookBuilder probe <book.bin> [<FEN>]" << endl;
+        cout << "  plies  add the first n plies of each game (default 20)" << endl;
+        cout << "  min    leave out moves played fewer than n times (default 1)" << endl;
+        cout << "  probe  list the book moves of the position (default: the starting position) and their weights" << endl;
+        return 1;
+    }
+    if (string(argv[1]) == "probe") {
+        // The FEN may be given as one argument or as its six fields
+        string fen;
+        for (int i = 3; i < argc; i++) {
+            fen += (i > 3 ? " " : "") + string(argv[i]);
+        }
+        return probeBook(argv[2], fen.empty() ? StartFEN : fen);
+    }
+
+    int maxPlies = 20;
+    uint32_t minWeight = 1;
+    for (int i = 3; i + 1 < argc; i += 2) {
+        if (string(argv[i]) == "plies") {
+            maxPlies = max(atoi(argv[i + 1]), 1);
+        }
+        else if (string(argv[i]) == "min") {
+            minWeight = static_cast<uint32_t>(max(atoi(argv[i + 1]), 1));
+        }
+    }
+    return buildBook(argv[1], argv[2], maxPlies, minWeight);
+}
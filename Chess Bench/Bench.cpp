@@ -0,0 +1,864 @@
+/*
+ * File: Bench.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Microbenchmarks of the engine's building blocks. Each benchmark checks that the fast version
+ *              gives the same results as the simple one before timing them.
+ */
+
+#include "Bitboard.h"
+#include "Classes.h"
+#include "Evaluation.h"
+#include "Helpers.h"
+#include "OpeningBook.h"
+#include "Renderer.h"
+#include "Search.h"
+#include "Tablebase.h"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Keeps the compiler from removing a benchmark loop whose result would otherwise be unused
+volatile uint64_t benchSink;
+
+double secondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+// Next number of a xorshift generator. Benchmarks use it instead of the standard generators so they time the
+// same inputs on every platform.
+uint64_t nextRandom(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+
+// Play games of random legal moves from the starting position. visit(board, moves, next) is called for every
+// position reached, the starting one included, with its legal moves and the move about to be played from it
+// (nullptr on the last position of a game). A game ends when it is over by the rules or after maxPlies moves.
+// With an openingWidth above 0, the move at ply p is picked among the first openingWidth + p legal moves, so
+// that the games share their first moves as real ones do. Returns false, stopping at once, when visit does.
+template <typename Visit>
+bool playRandomGames(int games, int maxPlies, uint64_t& state, Visit visit, int openingWidth = 0) {
+    Board board;
+    for (int game = 0; game < games; game++) {
+        board.fromFEN(StartFEN);
+        for (int ply = 0; ; ply++) {
+            MoveList moves = board.generateLegalMoves(board.getSideToMove());
+            const Move* next = nullptr;
+            if (ply < maxPlies && board.getGameEnd(moves.count) == GameEnd::None) {
+                int choices = (openingWidth > 0) ? min(moves.count, openingWidth + ply) : moves.count;
+                next = &moves[static_cast<int>(nextRandom(state) % static_cast<uint64_t>(choices))];
+            }
+            if (!visit(board, moves, next)) {
+                return false;
+            }
+            if (!next) {
+                break;
+            }
+            board.makeMove(*next);
+        }
+    }
+    return true;
+}
+
+// Time one attack function over every (square, occupancy) query, repeated, and return nanoseconds per lookup
+double timeAttacks(Bitboard (*attacks)(int, Bitboard), const vector<int>& squares, const vector<Bitboard>& occupancies, int repeats) {
+    auto startTime = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (size_t i = 0; i < squares.size(); i++) {
+            sum += attacks(squares[i], occupancies[i]);
+        }
+    }
+    benchSink = sum;
+    return secondsSince(startTime) * 1e9 / (static_cast<double>(squares.size()) * repeats);
+}
+
+// Ray-walk against table lookup for rook and bishop attacks, on random occupancies of middlegame density
+bool benchSliders() {
+    const int queries = 1 << 16;
+    const int repeats = 50;
+    vector<int> squares(queries);
+    vector<Bitboard> occupancies(queries);
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    for (int i = 0; i < queries; i++) {
+        squares[i] = static_cast<int>(nextRandom(state) % 64);
+        // About a quarter of the squares occupied
+        occupancies[i] = nextRandom(state) & nextRandom(state);
+    }
+
+    for (int i = 0; i < queries; i++) {
+        if (rookAttacks(squares[i], occupancies[i]) != rookRayAttacks(squares[i], occupancies[i])
+            || bishopAttacks(squares[i], occupancies[i]) != bishopRayAttacks(squares[i], occupancies[i])) {
+            cout << "Slider tables disagree with the ray walk on square " << squares[i] << endl;
+            return false;
+        }
+    }
+
+    cout << "Slider attacks (" << sliderIndexMethod() << " tables), ns per lookup:" << endl;
+    double rookRay = timeAttacks(rookRayAttacks, squares, occupancies, repeats);
+    double rookTable = timeAttacks(rookAttacks, squares, occupancies, repeats);
+    double bishopRay = timeAttacks(bishopRayAttacks, squares, occupancies, repeats);
+    double bishopTable = timeAttacks(bishopAttacks, squares, occupancies, repeats);
+    cout << "  rook    ray walk " << rookRay << "  table " << rookTable << "  speedup " << rookRay / rookTable << "x" << endl;
+    cout << "  bishop  ray walk " << bishopRay << "  table " << bishopTable << "  speedup " << bishopRay / bishopTable << "x" << endl;
+    return true;
+}
+
+// Positions from random games, written with toFEN, parsed back with fromFEN
+bool benchFEN() {
+    const int games = 200;
+    const int pliesPerGame = 100;
+    const int repeats = 20;
+
+    // Collect the positions of random games as one block of text, one FEN per line
+    string text;
+    vector<size_t> lineStarts;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    char fen[FENBufferSize];
+    playRandomGames(games, pliesPerGame, state, [&](const Board& board, const MoveList&, const Move*) {
+        lineStarts.push_back(text.size());
+        text.append(fen, board.toFEN(fen));
+        text += '\n';
+        return true;
+    });
+    lineStarts.push_back(text.size());
+    size_t positions = lineStarts.size() - 1;
+
+    // Every position must come back unchanged
+    Board board;
+    for (size_t i = 0; i < positions; i++) {
+        string_view line(text.data() + lineStarts[i], lineStarts[i + 1] - lineStarts[i] - 1);
+        if (!board.fromFEN(line) || board.toFEN(fen) != line.size() || line != fen) {
+            cout << "FEN round trip failed for " << line << endl;
+            return false;
+        }
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (size_t i = 0; i < positions; i++) {
+            board.fromFEN(string_view(text.data() + lineStarts[i], lineStarts[i + 1] - lineStarts[i] - 1));
+            sum += board.getHashKey();
+        }
+    }
+    double parseSeconds = secondsSince(startTime);
+
+    // Writing is timed on the last position loaded, as many times as there were positions parsed
+    startTime = chrono::steady_clock::now();
+    size_t written = 0;
+    for (size_t i = 0; i < positions * repeats; i++) {
+        written += board.toFEN(fen);
+    }
+    double writeSeconds = secondsSince(startTime);
+    benchSink = sum + written;
+
+    cout << "FEN, " << positions << " positions (" << text.size() / 1024 << " KB):" << endl;
+    cout << "  fromFEN " << text.size() * repeats / parseSeconds / 1e6 << " MB/s, "
+        << positions * repeats / parseSeconds / 1e6 << " M positions/s" << endl;
+    cout << "  toFEN   " << written / writeSeconds / 1e6 << " MB/s" << endl;
+    return true;
+}
+
+// Evaluation kept up to date by the board against the same evaluation summed over the pieces. Every position
+// of some random games is evaluated both ways, and so is every position one legal move away, which checks
+// that making and taking back each kind of move keeps the sums right.
+bool benchEval() {
+    const int games = 100;
+    const int pliesPerGame = 120;
+    const int repeats = 200;
+
+    vector<Board> positions;
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    bool agreed = playRandomGames(games, pliesPerGame, state, [&](const Board& position, const MoveList& moves, const Move*) {
+        Board board = position;
+        for (const Move& move : moves) {
+            board.makeMove(move);
+            bool same = board.getEvaluation() == evaluateFromScratch(board);
+            board.unmakeMove();
+            if (!same || board.getEvaluation() != evaluateFromScratch(board)) {
+                cout << "Evaluation mismatch around " << board.toFEN() << endl;
+                return false;
+            }
+        }
+        positions.push_back(position);
+        return true;
+    });
+    if (!agreed) {
+        return false;
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    int64_t sum = 0;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& position : positions) {
+            sum += position.getEvaluation();
+        }
+    }
+    double incrementalSeconds = secondsSince(startTime);
+
+    startTime = chrono::steady_clock::now();
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& position : positions) {
+            sum += evaluateFromScratch(position);
+        }
+    }
+    double scratchSeconds = secondsSince(startTime);
+    benchSink = static_cast<uint64_t>(sum);
+
+    double evaluations = static_cast<double>(positions.size()) * repeats;
+    cout << "Evaluation, " << positions.size() << " positions:" << endl;
+    cout << "  incremental   " << incrementalSeconds * 1e9 / evaluations << " ns/position" << endl;
+    cout << "  from scratch  " << scratchSeconds * 1e9 / evaluations << " ns/position" << endl;
+    return true;
+}
+
+// Insufficient material found by scanning the squares, as the board did before it kept piece counts
+bool insufficientMaterialFromScratch(const Board& board) {
+    int minors = 0, knights = 0, bishopsOn[2] = { 0, 0 };
+    for (int square = 0; square < 64; square++) {
+        Piece piece = board.getPieceAt(Position(square / 8, square % 8));
+        if (!piece || piece.getType() == Pieces::King) {
+            continue;
+        }
+        if (piece.getType() == Pieces::Knight) {
+            knights++;
+        }
+        else if (piece.getType() == Pieces::Bishop) {
+            bishopsOn[(square / 8 + square % 8) & 1]++;
+        }
+        else {
+            return false;
+        }
+        minors++;
+    }
+    return minors <= 1 || (knights == 0 && (bishopsOn[0] == 0 || bishopsOn[1] == 0));
+}
+
+// Draw detection from the piece counts against a scan of the squares, over random games played to their end so
+// that most of them reach endgames of few pieces. The draw check is then timed with and without the legal move
+// count, which the game has already computed when it asks.
+bool benchMaterial() {
+    const int games = 200;
+    const int maxPlies = 400;
+    const int repeats = 50;
+
+    vector<Board> positions;
+    vector<int> moveCounts;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    int insufficient = 0;
+    bool agreed = playRandomGames(games, maxPlies, state, [&](const Board& board, const MoveList& moves, const Move*) {
+        if (board.isInsufficientMaterial() != insufficientMaterialFromScratch(board)) {
+            cout << "Insufficient material mismatch in " << board.toFEN() << endl;
+            return false;
+        }
+        positions.push_back(board);
+        moveCounts.push_back(moves.count);
+        insufficient += board.isInsufficientMaterial() ? 1 : 0;
+        return true;
+    });
+    if (!agreed) {
+        return false;
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& position : positions) {
+            sum += position.isInsufficientMaterial() ? 1 : 0;
+        }
+    }
+    double countedSeconds = secondsSince(startTime);
+
+    startTime = chrono::steady_clock::now();
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& position : positions) {
+            sum += insufficientMaterialFromScratch(position) ? 1 : 0;
+        }
+    }
+    double scanSeconds = secondsSince(startTime);
+
+    startTime = chrono::steady_clock::now();
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (size_t i = 0; i < positions.size(); i++) {
+            sum += positions[i].isDraw(positions[i].getSideToMove(), moveCounts[i]) ? 1 : 0;
+        }
+    }
+    double drawCountedSeconds = secondsSince(startTime);
+
+    startTime = chrono::steady_clock::now();
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& position : positions) {
+            sum += position.isDraw(position.getSideToMove()) ? 1 : 0;
+        }
+    }
+    double drawSeconds = secondsSince(startTime);
+    benchSink = sum;
+
+    double checks = static_cast<double>(positions.size()) * repeats;
+    cout << "Material, " << positions.size() << " positions of " << games << " random games, " << insufficient
+        << " ended by insufficient material:" << endl;
+    cout << "  insufficient material, counts  " << countedSeconds * 1e9 / checks << " ns/position" << endl;
+    cout << "  insufficient material, scan    " << scanSeconds * 1e9 / checks << " ns/position" << endl;
+    cout << "  draw check, move count given   " << drawCountedSeconds * 1e9 / checks << " ns/position" << endl;
+    cout << "  draw check, moves generated    " << drawSeconds * 1e9 / checks << " ns/position" << endl;
+    return true;
+}
+
+// Positions searched by the search benchmark: the opening, tactical middlegames and endgames
+const char* const BenchPositions[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4",
+    "r2q1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 9",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/4k3/8/2p5/2P2K2/8/8 w - - 0 1",
+};
+
+// Count the leaf positions depth plies below the board by playing and taking back each move
+uint64_t perftMakeUnmake(Board& board, int depth) {
+    MoveList moves = board.generateLegalMoves(board.getSideToMove());
+    if (depth == 1) {
+        return static_cast<uint64_t>(moves.count);
+    }
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        board.makeMove(move);
+        nodes += perftMakeUnmake(board, depth - 1);
+        board.unmakeMove();
+    }
+    return nodes;
+}
+
+// The same count with copy-make: the position is saved once and restored from the snapshot after each move
+uint64_t perftCopyMake(Board& board, int depth) {
+    MoveList moves = board.generateLegalMoves(board.getSideToMove());
+    if (depth == 1) {
+        return static_cast<uint64_t>(moves.count);
+    }
+    BoardSnapshot snapshot;
+    board.saveSnapshot(snapshot);
+    uint64_t nodes = 0;
+    for (const Move& move : moves) {
+        board.makeMove(move);
+        nodes += perftCopyMake(board, depth - 1);
+        board.restoreSnapshot(snapshot);
+    }
+    return nodes;
+}
+
+// Board snapshots against the boards they were taken from, over the positions of random games: a board
+// restored from one must agree on the position, its key, evaluation, legal moves and repetitions. Then saving
+// and restoring are timed, and copy-make against make/unmake in a perft of the bench positions.
+bool benchSnapshot() {
+    const int games = 100;
+    const int pliesPerGame = 120;
+    const int repeats = 50;
+    const int perftDepth = 4;
+
+    vector<Board> positions;
+    uint64_t state = 0xD1B54A32D192ED03ULL;
+    bool agreed = playRandomGames(games, pliesPerGame, state, [&](const Board& board, const MoveList& moves, const Move*) {
+        BoardSnapshot snapshot;
+        board.saveSnapshot(snapshot);
+        Board restored(snapshot);
+        MoveList restoredMoves = restored.generateLegalMoves(restored.getSideToMove());
+        bool same = restored.toFEN() == board.toFEN() && restored.getHashKey() == board.getHashKey()
+            && restored.getEvaluation() == board.getEvaluation() && restoredMoves.count == moves.count
+            && restored.countRepetitions(2) == board.countRepetitions(2)
+            && restored.getAttackMap(Colors::White) == board.getAttackMap(Colors::White)
+            && restored.getAttackMap(Colors::Black) == board.getAttackMap(Colors::Black);
+        for (int i = 0; same && i < moves.count; i++) {
+            same = sameMove(moves[i], restoredMoves[i]);
+        }
+        if (!same) {
+            cout << "Snapshot mismatch in " << board.toFEN() << endl;
+            return false;
+        }
+        positions.push_back(board);
+        return true;
+    });
+    if (!agreed) {
+        return false;
+    }
+    Board board;
+
+    BoardSnapshot snapshot;
+    auto startTime = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& position : positions) {
+            position.saveSnapshot(snapshot);
+            sum += snapshot.hashKey;
+        }
+    }
+    double saveSeconds = secondsSince(startTime);
+
+    // Restoring is timed with the last snapshot saved
+    startTime = chrono::steady_clock::now();
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (size_t i = 0; i < positions.size(); i++) {
+            board.restoreSnapshot(snapshot);
+            sum += board.getHashKey();
+        }
+    }
+    double restoreSeconds = secondsSince(startTime);
+
+    double makeSeconds = 0, copySeconds = 0;
+    for (const char* fen : BenchPositions) {
+        board.fromFEN(fen);
+        startTime = chrono::steady_clock::now();
+        uint64_t made = perftMakeUnmake(board, perftDepth);
+        makeSeconds += secondsSince(startTime);
+        startTime = chrono::steady_clock::now();
+        uint64_t copied = perftCopyMake(board, perftDepth);
+        copySeconds += secondsSince(startTime);
+        if (made != copied) {
+            cout << "Copy-make perft " << copied << " instead of " << made << " in " << fen << endl;
+            return false;
+        }
+        sum += made;
+    }
+    benchSink = sum;
+
+    double saves = static_cast<double>(positions.size()) * repeats;
+    cout << "Snapshots of " << sizeof(BoardSnapshot) << " bytes, " << positions.size() << " positions:" << endl;
+    cout << "  save      " << saveSeconds * 1e9 / saves << " ns/snapshot" << endl;
+    cout << "  restore   " << restoreSeconds * 1e9 / saves << " ns/snapshot" << endl;
+    cout << "Perft " << perftDepth << " of the bench positions:" << endl;
+    cout << "  make/unmake  " << makeSeconds << " s" << endl;
+    cout << "  copy-make    " << copySeconds << " s" << endl;
+    return true;
+}
+
+// Fixed-depth search of every bench position, reporting the total node count and nodes per second. The
+// positions are searched once without and once with a transposition table, whose statistics are reported
+// along with the share of beta cutoffs made by the first move searched.
+bool benchSearch() {
+    const int depth = 5;
+    const size_t tableMegabytes = 16;
+    Board board;
+    TranspositionTable table(tableMegabytes);
+
+    for (TranspositionTable* searchTable : { static_cast<TranspositionTable*>(nullptr), &table }) {
+        Search search(searchTable);
+        uint64_t totalNodes = 0;
+        double totalSeconds = 0;
+        TTStats tableStats;
+        CutoffStats cutoffStats;
+
+        cout << "Search to depth " << depth;
+        if (searchTable) {
+            cout << " with a " << table.sizeInBytes() / (1024 * 1024) << " MB transposition table:" << endl;
+        }
+        else {
+            cout << " without a transposition table:" << endl;
+        }
+        for (const char* fen : BenchPositions) {
+            if (!board.fromFEN(fen)) {
+                cout << "Invalid bench position " << fen << endl;
+                return false;
+            }
+            if (searchTable) {
+                searchTable->clear();
+            }
+            SearchLimits limits;
+            limits.depth = depth;
+            SearchResult result = search.run(board, limits);
+            totalNodes += result.nodes;
+            totalSeconds += result.seconds;
+            tableStats += result.tableStats;
+            cutoffStats += result.cutoffStats;
+            cout << "  " << moveToString(result.bestMove) << " score " << result.score << " nodes " << result.nodes << "  " << fen << endl;
+        }
+        cout << "  total nodes " << totalNodes << "  time " << totalSeconds << " s  NPS "
+            << static_cast<uint64_t>(totalSeconds > 0 ? totalNodes / totalSeconds : 0) << endl;
+        cout << "  beta cutoffs " << cutoffStats.cutoffs << "  on the first move " << cutoffStats.firstMoveRate() * 100
+            << "%" << endl;
+        if (searchTable) {
+            cout << "  table probes " << tableStats.probes << "  hit rate " << tableStats.hitRate() * 100 << "%  cutoffs "
+                << tableStats.cutoffs << endl;
+            cout << "  table stores " << tableStats.stores << "  replacements " << tableStats.replacements
+                << "  full " << table.permilleFull() / 10.0 << "%" << endl;
+        }
+    }
+    return true;
+}
+
+// Parallel search to a fixed depth with 1, 2, 4, ... threads up to the number of cores (at least 2), reporting
+// how nodes per second and the time to reach the depth scale with the thread count
+bool benchParallelSearch() {
+    const int depth = 6;
+    const char* const positions[] = { BenchPositions[0], BenchPositions[2], BenchPositions[5] };
+    int maxThreads = max(static_cast<int>(thread::hardware_concurrency()), 2);
+    TranspositionTable table(64);
+    Board board;
+    double baseSeconds = 0, baseNPS = 0;
+
+    cout << "Parallel search to depth " << depth << " of " << size(positions) << " positions, "
+        << thread::hardware_concurrency() << " cores:" << endl;
+    vector<int> threadCounts;
+    for (int threads = 1; threads < maxThreads; threads *= 2) {
+        threadCounts.push_back(threads);
+    }
+    threadCounts.push_back(maxThreads);
+
+    for (int threads : threadCounts) {
+        uint64_t totalNodes = 0;
+        double totalSeconds = 0;
+        for (const char* fen : positions) {
+            if (!board.fromFEN(fen)) {
+                cout << "Invalid bench position " << fen << endl;
+                return false;
+            }
+            table.clear();
+            SearchLimits limits;
+            limits.depth = depth;
+            SearchResult result = Search::runParallel(board, limits, table, threads);
+            totalNodes += result.nodes;
+            totalSeconds += result.seconds;
+        }
+        double nps = totalSeconds > 0 ? totalNodes / totalSeconds : 0;
+        if (threads == 1) {
+            baseSeconds = totalSeconds;
+            baseNPS = nps;
+        }
+        cout << "  threads " << threads << "  nodes " << totalNodes << "  NPS " << static_cast<uint64_t>(nps)
+            << " (x" << nps / baseNPS << ")  time to depth " << totalSeconds << " s (x" << baseSeconds / totalSeconds << ")" << endl;
+    }
+    return true;
+}
+
+// Output stream that only counts the bytes written to it, standing in for a terminal
+class CountingBuffer : public streambuf {
+public:
+    uint64_t bytes = 0;
+
+protected:
+    int overflow(int c) override {
+        bytes++;
+        return c;
+    }
+    streamsize xsputn(const char*, streamsize count) override {
+        bytes += static_cast<uint64_t>(count);
+        return count;
+    }
+};
+
+// Render every position of a game in plain mode and in ANSI mode, where only changed squares are redrawn,
+// reporting the bytes sent per frame and the time to build and write a frame
+bool benchRender() {
+    const int plies = 200;
+    const int repeats = 200;
+    vector<Board> positions;
+    Board board;
+    for (int ply = 0; ply < plies; ply++) {
+        positions.push_back(board);
+        MoveList moves = board.generateLegalMoves(board.getSideToMove());
+        if (moves.count == 0) {
+            break;
+        }
+        board.makeMove(moves[(ply * 7) % moves.count]);
+    }
+
+    cout << "Render, " << positions.size() << " positions of a game:" << endl;
+    for (bool ansi : { false, true }) {
+        CountingBuffer counter;
+        ostream terminal(&counter);
+        auto startTime = chrono::steady_clock::now();
+        for (int repeat = 0; repeat < repeats; repeat++) {
+            BoardRenderer renderer(ansi);
+            for (const Board& position : positions) {
+                renderer.render(position, terminal);
+            }
+        }
+        double frames = static_cast<double>(positions.size()) * repeats;
+        cout << "  " << (ansi ? "ANSI " : "plain") << "  " << counter.bytes / frames << " bytes/frame  "
+            << secondsSince(startTime) * 1e9 / frames << " ns/frame" << endl;
+    }
+    return true;
+}
+
+// Generate some endgame tables into a temporary directory, timing each, then time probes of random positions of
+// them. Positions whose distance to mate is short are checked against a search of the same depth, which must
+// find the mate in exactly as many plies.
+bool benchTablebases() {
+    const char* const materials[] = { "KQvK", "KRvK", "KPvK", "KBNvK" };
+    const int positionsPerMaterial = 5000;
+    const int repeats = 100;
+    const int maxCheckedPlies = 5;
+    const int checksPerMaterial = 40;
+    int threads = max(static_cast<int>(thread::hardware_concurrency()), 1);
+
+    error_code error;
+    filesystem::path directory = filesystem::temp_directory_path(error) / "chess-bench-tablebases";
+    filesystem::remove_all(directory, error);
+    filesystem::create_directories(directory, error);
+    Tablebases tables;
+    cout << "Tablebases, generated on " << threads << " threads in " << directory.string() << ":" << endl;
+    for (const char* material : materials) {
+        if (!tables.generate(material, directory.string(), threads, cout)) {
+            return false;
+        }
+    }
+
+    // Random legal positions of each material, with the stronger side White or Black
+    uint64_t state = 0x5DEECE66DULL;
+    vector<Board> positions;
+    vector<TablebaseResult> results;
+    int checked = 0;
+    for (const char* material : materials) {
+        int found = 0, checks = 0;
+        while (found < positionsPerMaterial) {
+            bool strongIsWhite = nextRandom(state) % 2 == 0;
+            char squares[64];
+            fill(squares, squares + 64, '1');
+            bool valid = true;
+            for (const char* letter = material; *letter; letter++) {
+                if (*letter == 'v') {
+                    strongIsWhite = !strongIsWhite;
+                    continue;
+                }
+                int square = static_cast<int>(nextRandom(state) % 64);
+                valid = valid && squares[square] == '1' && !(*letter == 'P' && (square / 8 == 0 || square / 8 == 7));
+                squares[square] = strongIsWhite ? *letter : static_cast<char>(tolower(*letter));
+            }
+            string fen;
+            for (int row = 7; row >= 0; row--) {
+                fen.append(squares + row * 8, 8);
+                fen += (row > 0) ? '/' : ' ';
+            }
+            fen += (nextRandom(state) % 2) ? "w - - 0 1" : "b - - 0 1";
+            Board board;
+            if (!valid || !board.fromFEN(fen) || board.isInCheck(board.getSideToMove() == Colors::White ? Colors::Black : Colors::White)
+                || (KingAttacks[lowestSquare(board.getPieces(Colors::White, Pieces::King))] & board.getPieces(Colors::Black, Pieces::King))) {
+                continue;
+            }
+            TablebaseResult result;
+            if (!tables.probe(board, result)) {
+                cout << "No table for " << fen << endl;
+                return false;
+            }
+            positions.push_back(board);
+            results.push_back(result);
+            found++;
+
+            if (result.outcome != TablebaseOutcome::Draw && result.pliesToMate <= maxCheckedPlies && checks < checksPerMaterial) {
+                Search search;
+                SearchLimits limits;
+                limits.depth = result.pliesToMate + 1;
+                SearchResult searched = search.run(board, limits);
+                int expected = (result.outcome == TablebaseOutcome::Win) ? MateScore - result.pliesToMate : -(MateScore - result.pliesToMate);
+                if (searched.score != expected) {
+                    cout << "Tablebase and search disagree on " << fen << ": mate in " << result.pliesToMate
+                        << " plies, search score " << searched.score << endl;
+                    return false;
+                }
+                checks++;
+                checked++;
+            }
+        }
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& board : positions) {
+            TablebaseResult result;
+            tables.probe(board, result);
+            sum += static_cast<uint64_t>(result.pliesToMate);
+        }
+    }
+    double probeSeconds = secondsSince(startTime);
+    benchSink = sum;
+    cout << "  " << checked << " short mates confirmed by search" << endl;
+    cout << "  probe " << probeSeconds * 1e9 / (static_cast<double>(positions.size()) * repeats) << " ns/position ("
+        << positions.size() << " random positions)" << endl;
+    filesystem::remove_all(directory, error);
+    return true;
+}
+
+// Build a book from random games and look up every position of them, then time opening books of growing size:
+// opening one only maps it, so the time should not grow with the book.
+bool benchBook() {
+    const int games = 2000;
+    const int plies = 30;
+    const int repeats = 20;
+    const size_t bookSizes[] = { 1000, 100000, 1000000 };
+    const int opens = 100;
+
+    error_code error;
+    filesystem::path directory = filesystem::temp_directory_path(error) / "chess-bench-book";
+    filesystem::remove_all(directory, error);
+    filesystem::create_directories(directory, error);
+    string path = (directory / "games.bin").string();
+
+    uint64_t state = 0x853C49E6748FEA9BULL;
+    OpeningBookBuilder builder;
+    vector<Board> positions;
+    vector<Move> played;
+    playRandomGames(games, plies, state, [&](const Board& board, const MoveList&, const Move* next) {
+        if (next) {
+            builder.add(board, *next);
+            positions.push_back(board);
+            played.push_back(*next);
+        }
+        return true;
+    }, 2);
+    long long entries = builder.write(path.c_str());
+    OpeningBook book;
+    if (entries < 0 || !book.open(path.c_str())) {
+        cout << "Cannot write and open the book " << path << endl;
+        return false;
+    }
+    for (size_t i = 0; i < positions.size(); i++) {
+        BookMove moves[MaxMoves];
+        int found = book.findMoves(positions[i], moves, MaxMoves);
+        bool present = false;
+        for (int j = 0; j < found; j++) {
+            present = present || (moves[j].move.from == played[i].from && moves[j].move.to == played[i].to
+                && moves[j].move.promotion == played[i].promotion);
+        }
+        if (!present) {
+            cout << "Book move " << moveToString(played[i]) << " missing in " << positions[i].toFEN() << endl;
+            return false;
+        }
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (int repeat = 0; repeat < repeats; repeat++) {
+        for (const Board& position : positions) {
+            BookMove moves[MaxMoves];
+            sum += static_cast<uint64_t>(book.findMoves(position, moves, MaxMoves));
+        }
+    }
+    double lookupSeconds = secondsSince(startTime);
+    cout << "Opening book, " << positions.size() << " moves of " << games << " random games, " << entries << " entries:" << endl;
+    cout << "  lookup " << lookupSeconds * 1e9 / (static_cast<double>(positions.size()) * repeats) << " ns/position" << endl;
+
+    // Books of growing size from games of random moves, timed from opening to the first lookup
+    OpeningBookBuilder large;
+    for (size_t size : bookSizes) {
+        while (large.movesAdded() < size) {
+            playRandomGames(1, plies, state, [&large](const Board& board, const MoveList&, const Move* next) {
+                if (next) {
+                    large.add(board, *next);
+                }
+                return true;
+            });
+        }
+        string largePath = (directory / ("book" + to_string(size) + ".bin")).string();
+        large.write(largePath.c_str());
+        OpeningBook opened;
+        startTime = chrono::steady_clock::now();
+        for (int i = 0; i < opens; i++) {
+            opened.open(largePath.c_str());
+            BookMove moves[MaxMoves];
+            sum += static_cast<uint64_t>(opened.findMoves(positions[0], moves, MaxMoves));
+        }
+        cout << "  open + first lookup, " << opened.entryCount() << " entries (" << filesystem::file_size(largePath, error) / 1024
+            << " KB): " << secondsSince(startTime) * 1e6 / opens << " us" << endl;
+    }
+    benchSink = sum;
+    book.close();
+    filesystem::remove_all(directory, error);
+    return true;
+}
+
+// Morphy's Opera game (Paris, 1858), which ends in checkmate on the 33rd ply
+const char* const ReplayGame[] = {
+    "e2e4", "e7e5", "g1f3", "d7d6", "d2d4", "c8g4", "d4e5", "g4f3", "d1f3", "d6e5", "f1c4", "g8f6",
+    "f3b3", "d8e7", "b1c3", "c7c6", "c1g5", "b7b5", "c3b5", "c6b5", "c4b5", "b8d7", "e1c1", "a8d8",
+    "d1d7", "d8d7", "h1d1", "e7e6", "b5d7", "f6d7", "b3b8", "d7b8", "d1d8",
+};
+
+// A full game replayed through the Board calls the game makes for every move: movePiece, a check test for
+// each side, and the checkmate and draw tests of the side to move next. Every move must be played and only
+// the last one may end the game, in checkmate.
+bool benchReplay() {
+    const int replays = 1000;
+    const int plies = static_cast<int>(size(ReplayGame));
+
+    Board board;
+    auto startTime = chrono::steady_clock::now();
+    uint64_t sum = 0;
+    for (int replay = 0; replay < replays; replay++) {
+        board.fromFEN(StartFEN);
+        for (int ply = 0; ply < plies; ply++) {
+            const char* move = ReplayGame[ply];
+            Colors mover = board.getSideToMove();
+            Colors opponent = (mover == Colors::White) ? Colors::Black : Colors::White;
+            if (!board.movePiece(Position(move[1] - '1', move[0] - 'a'), Position(move[3] - '1', move[2] - 'a'))) {
+                cout << "Replay move " << move << " refused at ply " << ply + 1 << endl;
+                return false;
+            }
+            bool check = board.isInCheck(opponent);
+            bool mate = board.isCheckMate(opponent);
+            bool draw = board.isDraw(opponent);
+            if (board.isInCheck(mover) || mate != (ply == plies - 1) || draw) {
+                cout << "Replay ended wrongly at ply " << ply + 1 << " (" << move << ")" << endl;
+                return false;
+            }
+            sum += check;
+        }
+        sum += board.getHashKey();
+    }
+    double seconds = secondsSince(startTime);
+    benchSink = sum;
+
+    cout << "Replay of a " << plies << "-ply game, " << replays << " times:" << endl;
+    cout << "  " << seconds * 1e3 / replays << " ms/game" << endl;
+    return true;
+}
+
+struct Benchmark {
+    string name;
+    bool (*run)();
+};
+
+const Benchmark Benchmarks[] = {
+    { "sliders", benchSliders },
+    { "fen", benchFEN },
+    { "eval", benchEval },
+    { "material", benchMaterial },
+    { "search", benchSearch },
+    { "smp", benchParallelSearch },
+    { "snapshot", benchSnapshot },
+    { "render", benchRender },
+    { "tablebase", benchTablebases },
+    { "book", benchBook },
+    { "replay", benchReplay },
+};
+
+int main(int argc, char* argv[]) {
+    string only = (argc > 1) ? argv[1] : "";
+    bool found = false;
+    bool passed = true;
+    for (const Benchmark& benchmark : Benchmarks) {
+        if (only.empty() || only == benchmark.name) {
+            found = true;
+            passed = benchmark.run() && passed;
+        }
+    }
+    if (!found) {
+        cout << "Usage: Bench [name]" << endl;
+        cout << "  name  run only this benchmark:";
+        for (const Benchmark& benchmark : Benchmarks) {
+            cout << " " << benchmark.name;
+        }
+        cout << endl;
+        return 1;
+    }
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,271 @@
+/*
+ * File: Bitboard.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the bitboard attack tables, including the magic/PEXT slider tables.
+ */
+
+#include "Bitboard.h"
+#include <cstddef>
+
+// The BMI2 PEXT instruction is only used on x86-64, and only when the processor reports support for it
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#define HAS_PEXT_PATH 1
+#define PEXT_TARGET
+#elif (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define HAS_PEXT_PATH 1
+#define PEXT_TARGET __attribute__((target("bmi2")))
+#else
+#define HAS_PEXT_PATH 0
+#endif
+
+namespace {
+    // Ray directions as {row step, col step}. The first four increase the square index, the last four decrease it.
+    enum Direction { North, East, NorthEast, NorthWest, South, West, SouthWest, SouthEast };
+    constexpr int DirectionSteps[8][2] = { {1, 0}, {0, 1}, {1, 1}, {1, -1}, {-1, 0}, {0, -1}, {-1, -1}, {-1, 1} };
+
+    constexpr bool onBoard(int row, int col) {
+        return row >= 0 && row < 8 && col >= 0 && col < 8;
+    }
+
+    // Build a table of the squares reachable in one jump by a piece with the given steps
+    template <std::size_t N>
+    constexpr std::array<Bitboard, 64> buildLeaperTable(const int (&steps)[N][2]) {
+        std::array<Bitboard, 64> table{};
+        for (int square = 0; square < 64; square++) {
+            int row = square / 8, col = square % 8;
+            for (const auto& step : steps) {
+                if (onBoard(row + step[0], col + step[1])) {
+                    table[square] |= 1ULL << ((row + step[0]) * 8 + col + step[1]);
+                }
+            }
+        }
+        return table;
+    }
+
+    // Build the full (empty board) ray from every square in every direction
+    constexpr std::array<std::array<Bitboard, 64>, 8> buildRays() {
+        std::array<std::array<Bitboard, 64>, 8> rays{};
+        for (int direction = 0; direction < 8; direction++) {
+            for (int square = 0; square < 64; square++) {
+                int row = square / 8 + DirectionSteps[direction][0];
+                int col = square % 8 + DirectionSteps[direction][1];
+                while (onBoard(row, col)) {
+                    rays[direction][square] |= 1ULL << (row * 8 + col);
+                    row += DirectionSteps[direction][0];
+                    col += DirectionSteps[direction][1];
+                }
+            }
+        }
+        return rays;
+    }
+
+    constexpr int KnightSteps[8][2] = { {1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2} };
+    constexpr int KingSteps[8][2] = { {1, 0}, {0, 1}, {1, 1}, {1, -1}, {-1, 0}, {0, -1}, {-1, -1}, {-1, 1} };
+    constexpr int WhitePawnSteps[2][2] = { {1, -1}, {1, 1} };
+    constexpr int BlackPawnSteps[2][2] = { {-1, -1}, {-1, 1} };
+
+    constexpr std::array<std::array<Bitboard, 64>, 8> Rays = buildRays();
+
+    // The squares between every two squares on a shared line, or the whole line through them. A square's ray in
+    // one direction, without the part of the ray that continues past the other square, is what lies between.
+    constexpr std::array<std::array<Bitboard, 64>, 64> buildLineTable(bool wholeLine) {
+        std::array<std::array<Bitboard, 64>, 64> table{};
+        for (int from = 0; from < 64; from++) {
+            for (int direction = 0; direction < 8; direction++) {
+                Bitboard ray = Rays[direction][from];
+                Bitboard line = ray | Rays[(direction + 4) % 8][from] | (1ULL << from);
+                for (int to = 0; to < 64; to++) {
+                    if (ray & (1ULL << to)) {
+                        table[from][to] = wholeLine ? line : ray & ~Rays[direction][to] & ~(1ULL << to);
+                    }
+                }
+            }
+        }
+        return table;
+    }
+
+    // Attacks along one ray: the ray up to and including the nearest blocker
+    inline Bitboard rayAttacks(int direction, int square, Bitboard occupied) {
+        Bitboard attacks = Rays[direction][square];
+        Bitboard blockers = attacks & occupied;
+        if (blockers) {
+            int blocker = (direction < South) ? lowestSquare(blockers) : highestSquare(blockers);
+            attacks ^= Rays[direction][blocker];
+        }
+        return attacks;
+    }
+}
+
+const std::array<Bitboard, 64> KnightAttacks = buildLeaperTable(KnightSteps);
+const std::array<Bitboard, 64> KingAttacks = buildLeaperTable(KingSteps);
+const std::array<std::array<Bitboard, 64>, 2> PawnAttacks = { buildLeaperTable(WhitePawnSteps), buildLeaperTable(BlackPawnSteps) };
+const std::array<std::array<Bitboard, 64>, 64> BetweenSquares = buildLineTable(false);
+const std::array<std::array<Bitboard, 64>, 64> LineThrough = buildLineTable(true);
+
+Bitboard rookRayAttacks(int square, Bitboard occupied) {
+    return rayAttacks(North, square, occupied) | rayAttacks(East, square, occupied)
+        | rayAttacks(South, square, occupied) | rayAttacks(West, square, occupied);
+}
+
+Bitboard bishopRayAttacks(int square, Bitboard occupied) {
+    return rayAttacks(NorthEast, square, occupied) | rayAttacks(NorthWest, square, occupied)
+        | rayAttacks(SouthWest, square, occupied) | rayAttacks(SouthEast, square, occupied);
+}
+
+namespace {
+    // Lookup data of one square for one slider. Only the squares in the mask can block the slider: the ray
+    // squares except the last one on each ray, since a piece there does not change which squares are attacked.
+    // Every subset of the mask gets its own entry in the attack table, found with either index function:
+    //   magic: ((occupied & mask) * magic) >> shift, with a magic number that maps no two subsets with
+    //          different attacks to the same entry
+    //   PEXT:  the mask bits of the occupancy packed together, which is a perfect index by construction
+    struct SliderSquare {
+        Bitboard mask;
+        Bitboard magic;
+        int shift;
+        Bitboard* attacks;
+    };
+
+    // 4096 entries for a rook in a corner down to 1024 in the middle; 32 to 512 for a bishop
+    const int RookTableSize = 102400;
+    const int BishopTableSize = 5248;
+
+    Bitboard RookTable[RookTableSize];
+    Bitboard BishopTable[BishopTableSize];
+    SliderSquare RookSquares[64];
+    SliderSquare BishopSquares[64];
+    bool UsePext = false;
+
+#if HAS_PEXT_PATH
+    PEXT_TARGET Bitboard pextIndex(Bitboard occupied, Bitboard mask) {
+        return _pext_u64(occupied, mask);
+    }
+
+    bool cpuSupportsBmi2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuidex(info, 0, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 8)) != 0;
+#else
+        return __builtin_cpu_supports("bmi2");
+#endif
+    }
+#endif
+
+    inline Bitboard sliderLookup(const SliderSquare& entry, Bitboard occupied) {
+#if HAS_PEXT_PATH
+        if (UsePext) {
+            return entry.attacks[pextIndex(occupied, entry.mask)];
+        }
+#endif
+        return entry.attacks[((occupied & entry.mask) * entry.magic) >> entry.shift];
+    }
+
+    // Small fast generator for magic number candidates. Seeded per row with values known to find a magic
+    // number for every square of that row within a few thousand candidates, so startup stays quick.
+    struct Xorshift {
+        uint64_t state;
+        uint64_t next() {
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 0x2545F4914F6CDD1DULL;
+        }
+        // Candidates with few set bits make good magic numbers much more often
+        uint64_t sparse() {
+            return next() & next() & next();
+        }
+    };
+
+    // Fill the table of one slider for every square, finding a magic number per square unless PEXT is used
+    void initSlider(SliderSquare* squares, Bitboard* table, Bitboard (*rayWalk)(int, Bitboard)) {
+        Bitboard occupancies[4096];
+        Bitboard references[4096];
+        int usedInTry[4096] = {};
+        const uint64_t rowSeeds[8] = { 728, 10316, 55013, 32803, 12281, 15100, 16645, 255 };
+        Bitboard* nextTable = table;
+        int tryNumber = 0;
+
+        for (int square = 0; square < 64; square++) {
+            int row = square / 8, col = square % 8;
+            Bitboard edges = ((Row0 | Row7) & ~(Row0 << (row * 8))) | ((FileA | FileH) & ~(FileA << col));
+            SliderSquare& entry = squares[square];
+            entry.mask = rayWalk(square, 0) & ~edges;
+            entry.shift = 64 - popCount(entry.mask);
+            entry.attacks = nextTable;
+
+            // Every subset of the mask, with the attacks it leaves, using the carry-rippler trick
+            int size = 0;
+            Bitboard subset = 0;
+            do {
+                occupancies[size] = subset;
+                references[size] = rayWalk(square, subset);
+                size++;
+                subset = (subset - entry.mask) & entry.mask;
+            } while (subset);
+            nextTable += size;
+
+            if (UsePext) {
+#if HAS_PEXT_PATH
+                for (int i = 0; i < size; i++) {
+                    entry.attacks[pextIndex(occupancies[i], entry.mask)] = references[i];
+                }
+#endif
+                continue;
+            }
+
+            // Try candidates until one sends every subset to an entry that is free or already holds the same attacks
+            Xorshift random = { rowSeeds[row] };
+            bool found = false;
+            while (!found) {
+                entry.magic = random.sparse();
+                if (popCount((entry.mask * entry.magic) >> 56) < 6) {
+                    continue;
+                }
+                tryNumber++;
+                found = true;
+                for (int i = 0; i < size && found; i++) {
+                    Bitboard index = (occupancies[i] * entry.magic) >> entry.shift;
+                    if (usedInTry[index] != tryNumber) {
+                        usedInTry[index] = tryNumber;
+                        entry.attacks[index] = references[i];
+                    }
+                    else if (entry.attacks[index] != references[i]) {
+                        found = false;
+                    }
+                }
+            }
+        }
+    }
+
+    // Fills the slider tables before main runs
+    struct SliderTablesInit {
+        SliderTablesInit() {
+#if HAS_PEXT_PATH
+            UsePext = cpuSupportsBmi2();
+#endif
+            initSlider(RookSquares, RookTable, rookRayAttacks);
+            initSlider(BishopSquares, BishopTable, bishopRayAttacks);
+        }
+    } sliderTablesInit;
+}
+
+Bitboard rookAttacks(int square, Bitboard occupied) {
+    return sliderLookup(RookSquares[square], occupied);
+}
+
+Bitboard bishopAttacks(int square, Bitboard occupied) {
+    return sliderLookup(BishopSquares[square], occupied);
+}
+
+const char* sliderIndexMethod() {
+    return UsePext ? "pext" : "magic";
+}
@@ -0,0 +1,78 @@
+/*
+ * File: Bitboard.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the bitboard type, square helpers and attack tables.
+ */
+
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+// A set of squares, one bit per square. Square index = row * 8 + col, so a1 (row 0, col 0) is bit 0.
+typedef uint64_t Bitboard;
+
+const Bitboard FileA = 0x0101010101010101ULL;
+const Bitboard FileH = FileA << 7;
+const Bitboard Row0 = 0xFFULL;
+const Bitboard Row7 = Row0 << 56;
+
+inline int squareIndex(int row, int col) {
+    return row * 8 + col;
+}
+
+inline Bitboard squareBit(int square) {
+    return 1ULL << square;
+}
+
+inline int popCount(Bitboard bitboard) {
+    return std::popcount(bitboard);
+}
+
+// Index of the lowest set square. The bitboard must not be empty.
+inline int lowestSquare(Bitboard bitboard) {
+    return std::countr_zero(bitboard);
+}
+
+// Index of the highest set square. The bitboard must not be empty.
+inline int highestSquare(Bitboard bitboard) {
+    return 63 - std::countl_zero(bitboard);
+}
+
+// Remove the lowest set square from the bitboard and return its index
+inline int popLowestSquare(Bitboard& bitboard) {
+    int square = std::countr_zero(bitboard);
+    bitboard &= bitboard - 1;
+    return square;
+}
+
+// Attack tables for the pieces that do not slide. Pawn tables are indexed by [color index][square],
+// where color index 0 is White (moving towards higher rows) and 1 is Black.
+extern const std::array<Bitboard, 64> KnightAttacks;
+extern const std::array<Bitboard, 64> KingAttacks;
+extern const std::array<std::array<Bitboard, 64>, 2> PawnAttacks;
+
+// Line tables, indexed by [square][square]. Between holds the squares strictly between two squares that share a
+// row, column or diagonal; LineThrough holds the whole line through them, edge to edge. Both are empty for two
+// squares that share no line.
+extern const std::array<std::array<Bitboard, 64>, 64> BetweenSquares;
+extern const std::array<std::array<Bitboard, 64>, 64> LineThrough;
+
+// Attacks of sliding pieces from a square, stopping at (and including) the first occupied square on each ray.
+// These are lookups in tables filled at startup, indexed with magic multiplication or with BMI2 PEXT when the
+// processor supports it.
+Bitboard rookAttacks(int square, Bitboard occupied);
+Bitboard bishopAttacks(int square, Bitboard occupied);
+
+// The same attacks found by walking each ray. Used to fill the tables, and as a reference to check them against.
+Bitboard rookRayAttacks(int square, Bitboard occupied);
+Bitboard bishopRayAttacks(int square, Bitboard occupied);
+
+// How the slider tables are indexed on this processor: "pext" or "magic"
+const char* sliderIndexMethod();
+
+inline Bitboard queenAttacks(int square, Bitboard occupied) {
+    return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+}
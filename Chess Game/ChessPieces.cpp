@@ -2,54 +2,65 @@
  * File: ChessPieces.cpp
  * Author: Omri Shalev
  * Date: September 16, 2023
- * Description: Implementation of chess piece classes.
+ * Description: Implementation of the movement rules of the chess pieces.
  */
 
 #include "ChessPieces.h"
 #include "Classes.h"
+#include "Trace.h"
 
-// Forawad declarations 
-class Board;
-class Piece;
-
-/* ---------------------------------- Pawn ----------------------------------  */
-Pawn::Pawn(Colors color, Position pos) : Piece(color, Pieces::Pawn, pos) {}
+/* ---------------------------------- Piece ----------------------------------  */
+namespace {
+    // Indexed by Pieces
+    const char* const PieceNames[] = { "", "Pawn", "Knight", "Bishop", "Rook", "Queen", "King" };
+    const char WhiteSymbols[] = " PNBRQK";
+    const char BlackSymbols[] = " pnbrqk";
+}
 
-string Pawn::getName() const {
-    return "Pawn";
+string Piece::getName() const {
+    return PieceNames[static_cast<int>(getType())];
 }
 
-Pieces Pawn::getType() const {
-    return Pieces::Pawn;
+char Piece::getSymbol() const {
+    return (getColor() == Colors::White) ? WhiteSymbols[static_cast<int>(getType())] : BlackSymbols[static_cast<int>(getType())];
 }
 
-char Pawn::getSymbol() const {
-    return (pieceColor == Colors::White) ? 'P' : 'p'; // U+2659 for white pawn, U+265F for black pawn
+bool Piece::isValidMove(Position start, Position end, const Board& board) const {
+    TRACE_EVENT(TraceEvent::Validation, getType(), squareIndex(start), squareIndex(end));
+
+    switch (getType()) {
+    case Pieces::Pawn: return isValidPawnMove(getColor(), start, end, board);
+    case Pieces::Knight: return isValidKnightMove(getColor(), start, end, board);
+    case Pieces::Bishop: return isValidBishopMove(getColor(), start, end, board);
+    case Pieces::Rook: return isValidRookMove(getColor(), start, end, board);
+    case Pieces::Queen: return isValidQueenMove(getColor(), start, end, board);
+    case Pieces::King: return isValidKingMove(getColor(), start, end, board);
+    default: return false; // An empty square cannot move
+    }
 }
 
-bool Pawn::isValidMove(Position start, Position end, const Board& board) const{
-    // debug
-    cout << "Checking move for " << getName()
-        << " from (" << start.row << "," << start.col << ")"
-        << " to (" << end.row << "," << end.col << ")" << endl;
-    
+
+/* ---------------------------------- Pawn ----------------------------------  */
+bool isValidPawnMove(Colors color, Position start, Position end, const Board& board) {
     // Check if the destination is within the bounds of the board
     if (end.row < 0 || end.row >= 8 || end.col < 0 || end.col >= 8) {
         return false;
     }
     /* if Color = white so direction is to move forward on the board
        else if the color = black so move backward on the board. */
-    int direction = (pieceColor == Colors::White) ? 1 : -1;
-    // Forward move
+    int direction = (color == Colors::White) ? 1 : -1;
+    // Forward move, only to empty squares
     if (start.col == end.col) {
-        if (start.row + direction == end.row) 
+        if (start.row + direction == end.row && !board.getPieceAt(end)) 
             return true; // Move one forward
-        if (!hasMoved && start.row + 2 * direction == end.row) 
+        if (!board.hasPieceMoved(start) && start.row + 2 * direction == end.row
+            && !board.getPieceAt({ start.row + direction, start.col }) && !board.getPieceAt(end)) 
             return true; // First move, two forward
     }
-    // Diagonal capture
+    // Diagonal capture, or en passant capture of a pawn that just skipped the end square
     if (start.row + direction == end.row && abs(start.col - end.col) == 1) {
-        if (board.isOpponentAt(end, pieceColor)) {
+        int enPassantRow = (color == Colors::White) ? 5 : 2;
+        if (board.isOpponentAt(end, color) || (end.row == enPassantRow && board.isEnPassantAt(end))) {
             return true;
         }
     }
@@ -58,84 +69,27 @@ bool Pawn::isValidMove(Position start, Position end, const Board& board) const{
 
 
 /* ---------------------------------- Rook ----------------------------------  */
-Rook::Rook(Colors color, Position pos) : Piece(color, Pieces::Rook, pos) {}
-
-string Rook::getName() const {
-    return "Rook";
-}
-
-Pieces Rook::getType() const {
-    return Pieces::Rook;
-}
-
-char Rook::getSymbol() const {
-    return (pieceColor == Colors::White) ? 'R' : 'r'; // White Rook: ♖, Black Rook: ♜
-}
-
-bool Rook::isValidMove(Position start, Position end, const Board& board) const {
-    // debug
-    cout << "Checking move for " << getName()
-        << " from (" << start.row << "," << start.col << ")"
-        << " to (" << end.row << "," << end.col << ")" << endl;
-    
-    // Rooks can move either horizontally or vertically.
-    if (start.row == end.row || start.col == end.col) {
-        // Check if there are no pieces in the way
-        int rowStep = (start.row == end.row) ? 0 : ((end.row > start.row) ? 1 : -1);
-        int colStep = (start.col == end.col) ? 0 : ((end.col > start.col) ? 1 : -1);
-       
-        int currentRow = start.row + rowStep;
-        int currentCol = start.col + colStep;
-
-        while (currentRow != end.row || currentCol != end.col) {
-            // Check if there's a piece at the current position
-            Piece* pieceAtCurrent = board.getPieceAt({ currentRow, currentCol });
-
-            if (pieceAtCurrent) {
-                return false;
-            }
-            
-            currentRow += rowStep;
-            currentCol += colStep;
-        }
-        // No pieces in the way, so it's a valid non-capture move
-        return true;
+bool isValidRookMove(Colors color, Position start, Position end, const Board& board) {
+    // Rooks move along a row or column, up to and including the first piece in the way
+    if (!(rookAttacks(squareIndex(start), board.getOccupied()) & squareBit(squareIndex(end)))) {
+        return false;
     }
-    return false; // Rooks can only move horizontally or vertically
+    // Cannot capture own piece
+    return !(board.getPiecesOf(color) & squareBit(squareIndex(end)));
 }
 
 /* ---------------------------------- Knight ----------------------------------  */
-
-Knight::Knight(Colors color, Position pos) : Piece(color, Pieces::Knight, pos) {}
-
-string Knight::getName() const {
-    return "Knight";
-}
-
-Pieces Knight::getType() const {
-    return Pieces::Knight;
-}
-
-char Knight::getSymbol() const {
-    return (pieceColor == Colors::White) ? 'N' : 'n'; // White Knight: ♘, Black Knight: ♞
-}
-
-bool Knight::isValidMove(Position start, Position end, const Board& board) const {
-    // debug
-    cout << "Checking move for " << getName()
-        << " from (" << start.row << "," << start.col << ")"
-        << " to (" << end.row << "," << end.col << ")" << endl;
-
+bool isValidKnightMove(Colors color, Position start, Position end, const Board& board) {
     int dx = abs(start.row - end.row);
     int dy = abs(start.col - end.col);
 
     // Knights move in an "L" shape, so they can jump over other pieces.
     // Check if the move is valid for a knight.
     if ((dx == 1 && dy == 2) || (dx == 2 && dy == 1)) {
-        Piece* pieceAtEnd = board.getPieceAt(end);
+        Piece pieceAtEnd = board.getPieceAt(end);
 
         // If there's no piece at the destination or it's an opponent's piece, it's a valid move.
-        if (!pieceAtEnd || pieceAtEnd->getColor() != pieceColor) {
+        if (!pieceAtEnd || pieceAtEnd.getColor() != color) {
             return true;
         }
     }
@@ -145,191 +99,35 @@ bool Knight::isValidMove(Position start, Position end, const Board& board) const
 
 
 /* ---------------------------------- Bishop ----------------------------------  */
-Bishop::Bishop(Colors color, Position pos) : Piece(color, Pieces::Bishop, pos) {}
-
-string Bishop::getName() const {
-    return "Bishop";
-}
-
-Pieces Bishop::getType() const {
-    return Pieces::Bishop;
-}
-
-char Bishop::getSymbol() const {
-    return (pieceColor == Colors::White) ? 'B' : 'b'; // White Bishop: ♗, Black Bishop: ♝
-}
-
-bool Bishop::isValidMove(Position start, Position end, const Board& board) const {
-    // debug
-    cout << "Checking move for " << getName()
-        << " from (" << start.row << "," << start.col << ")"
-        << " to (" << end.row << "," << end.col << ")" << endl;
-    
-    // Check if the move is diagonal (both row and column movements have the same absolute value)
-    int dx = abs(start.row - end.row);
-    int dy = abs(start.col - end.col);
-
-    if (dx != dy) {
-        return false; // Not a diagonal move
-    }
-
-    // Determine the direction of movement (up-right, up-left, down-right, or down-left)
-    int rowStep = (end.row > start.row) ? 1 : -1;
-    int colStep = (end.col > start.col) ? 1 : -1;
-
-    int currentRow = start.row + rowStep;
-    int currentCol = start.col + colStep;
-
-    while (currentRow != end.row || currentCol != end.col) {
-        Piece* pieceAtCurrent = board.getPieceAt({ currentRow, currentCol });
-        if (pieceAtCurrent) {
-            return false;
-        }
-
-        currentRow += rowStep;
-        currentCol += colStep;         
-    }
-
-    // Check for a piece at the destination
-    Piece* pieceAtEnd = board.getPieceAt(end);
-    if (pieceAtEnd && pieceAtEnd->getColor() == pieceColor) {
-        return false; // Cannot capture own piece
+bool isValidBishopMove(Colors color, Position start, Position end, const Board& board) {
+    // Bishops move along a diagonal, up to and including the first piece in the way
+    if (!(bishopAttacks(squareIndex(start), board.getOccupied()) & squareBit(squareIndex(end)))) {
+        return false;
     }
-
-    // No pieces in the way, so it's a valid move
-    return true;
+    // Cannot capture own piece
+    return !(board.getPiecesOf(color) & squareBit(squareIndex(end)));
 }
 
 
 /* ---------------------------------- Queen ----------------------------------  */
-Queen::Queen(Colors color, Position pos) : Piece(color, Pieces::Queen, pos) {}
-
-string Queen::getName() const {
-    return "Queen";
-}
-
-Pieces Queen::getType() const {
-    return Pieces::Queen;
-}
-
-char Queen::getSymbol() const {
-    return (pieceColor == Colors::White) ? 'Q' : 'q'; // White Queen: ♕, Black Queen: ♛
-}
-
-//bool Queen::isValidMove(Position start, Position end, const Board& board) const {
-//    int dx = abs(start.row - end.row);
-//    int dy = abs(start.col - end.col);
-//    if (start.row == end.row || start.col == end.col || dx == dy) {
-//        // Determine the direction of movement
-//        int rowStep = (end.row > start.row) ? 1 : (end.row < start.row) ? -1 : 0;
-//        int colStep = (end.col > start.col) ? 1 : (end.col < start.col) ? -1 : 0;
-//
-//        int currentRow = start.row + rowStep;
-//        int currentCol = start.col + colStep;
-//
-//        while (currentRow != end.row && currentCol != end.col) {
-//            Piece* pieceAtCurrent = board.getPieceAt({ currentRow, currentCol });
-//            if (pieceAtCurrent->getColor() == pieceColor) {
-//                return false; // There's a piece blocking the Queen's path
-//            }
-//
-//            currentRow += rowStep;
-//            currentCol += colStep;
-//        }
-//    }
-//    //// Check for a piece at the destination
-//    //Piece* pieceAtEnd = board.getPieceAt(end);
-//    //if (pieceAtEnd && pieceAtEnd->getColor() == pieceColor) {
-//    //    return false; // Cannot capture own piece
-//    //}
-//
-//    return true; // No pieces blocking the way, so it's a valid move
-//}
-
-bool Queen::isValidMove(Position start, Position end, const Board& board) const {
-    // debug
-    cout << "Checking move for " << getName()
-        << " from (" << start.row << "," << start.col << ")"
-        << " to (" << end.row << "," << end.col << ")" << endl;
-    
-    // Check for horizontal or vertical movement (like a Rook)
-    if (start.row == end.row || start.col == end.col) {
-        int rowStep = (start.row == end.row) ? 0 : ((end.row > start.row) ? 1 : -1);
-        int colStep = (start.col == end.col) ? 0 : ((end.col > start.col) ? 1 : -1);
-
-        int currentRow = start.row + rowStep;
-        int currentCol = start.col + colStep;
-
-        while (currentRow != end.row || currentCol != end.col) {
-            if (board.getPieceAt({ currentRow, currentCol })) {
-                return false; // There's a piece blocking the path.
-            }
-
-            currentRow += rowStep;
-            currentCol += colStep;
-        }
-        // No pieces in the way, so it's a valid move
-        Piece* pieceAtEnd = board.getPieceAt(end);
-        if (pieceAtEnd && pieceAtEnd->getColor() == pieceColor) {
-            return false;  // Trying to capture a piece of the same color
-        }
-        return true;
-    }
-    // Check for diagonal movement (like a Bishop)
-    int dx = abs(start.row - end.row);
-    int dy = abs(start.col - end.col);
-    if (dx == dy) {
-        int rowStep = (end.row > start.row) ? 1 : -1;
-        int colStep = (end.col > start.col) ? 1 : -1;
-
-        int currentRow = start.row + rowStep;
-        int currentCol = start.col + colStep;
-
-        while (currentRow != end.row && currentCol != end.col) {
-            if (board.getPieceAt({ currentRow, currentCol })) {
-                return false; // There's a piece blocking the path.
-            }
-            currentRow += rowStep;
-            currentCol += colStep;
-        }
-        Piece* pieceAtEnd = board.getPieceAt(end);
-        if (pieceAtEnd && pieceAtEnd->getColor() == pieceColor) {
-            return false;  // Trying to capture a piece of the same color
-        }
-        return true; // Path is clear
+bool isValidQueenMove(Colors color, Position start, Position end, const Board& board) {
+    // Queens move like a rook or a bishop, up to and including the first piece in the way
+    if (!(queenAttacks(squareIndex(start), board.getOccupied()) & squareBit(squareIndex(end)))) {
+        return false;
     }
-
-    // Not a valid Rook or Bishop move, hence invalid for a Queen.
-    return false;
+    // Cannot capture own piece
+    return !(board.getPiecesOf(color) & squareBit(squareIndex(end)));
 }
 
 /* ---------------------------------- King ----------------------------------  */
-King::King(Colors color, Position pos) : Piece(color, Pieces::King, pos) {}
-
-string King::getName() const {
-    return "King";
-}
-
-Pieces King::getType() const {
-    return Pieces::King;
-}
-
-char King::getSymbol() const {
-    return (pieceColor == Colors::White) ? 'K' : 'k'; // White King: ♔, Black King: ♚
-}
-
-bool King::isValidMove(Position start, Position end, const Board& board) const {
-    cout << "Checking move for " << getName()
-        << " from (" << start.row << "," << start.col << ")"
-        << " to (" << end.row << "," << end.col << ")" << endl;
-
+bool isValidKingMove(Colors color, Position start, Position end, const Board& board) {
     int dx = abs(start.row - end.row);
     int dy = abs(start.col - end.col);
 
     // Check if the move is within one square in any direction
     if (dx <= 1 && dy <= 1) {
-        Piece* pieceAtEnd = board.getPieceAt(end);
-        if (pieceAtEnd && pieceAtEnd->getColor() == pieceColor) {
+        Piece pieceAtEnd = board.getPieceAt(end);
+        if (pieceAtEnd && pieceAtEnd.getColor() == color) {
             return false; // Cannot capture own piece
         }
         return true;
@@ -345,10 +143,3 @@ bool King::isValidMove(Position start, Position end, const Board& board) const {
 
     return false;
 }
-
-
-
-
-
-
-
@@ -2,63 +2,18 @@
  * File: ChessPieces.h
  * Author: Omri Shalev
  * Date: September 16, 2023
- * Description: Header file containing declarations for chess piece classes.
+ * Description: Header file containing declarations of the movement rules of each chess piece.
  */
 
 #pragma once 
 
 #include "Classes.h"
 
-class Pawn : public Piece {
-public:
-    Pawn(Colors color, Position pos);
-    bool isValidMove(Position start, Position end, const Board& board) const override;
-    string getName() const override; 
-    Pieces getType() const override;
-    char getSymbol() const override;
-};
-
-class Rook : public Piece {
-public:
-    Rook(Colors color, Position pos);
-    bool isValidMove(Position start, Position end, const Board& board) const override;
-    string getName() const override;
-    Pieces getType() const;
-    char getSymbol() const;
-};
-
-class Knight : public Piece {
-public:
-    Knight(Colors color, Position pos);
-    bool isValidMove(Position start, Position end, const Board& board) const override;
-    string getName() const;
-    Pieces getType() const;
-    char getSymbol() const;
-};
-
-class Bishop : public Piece {
-public:
-    Bishop(Colors color, Position pos);
-    bool isValidMove(Position start, Position end, const Board& board) const override;
-    string getName() const;
-    Pieces getType() const;
-    char getSymbol() const;
-};
-
-class Queen : public Piece {
-public:
-    Queen(Colors color, Position pos);
-    bool isValidMove(Position start, Position end, const Board& board) const override;
-    string getName() const;
-    Pieces getType() const;
-    char getSymbol() const;  
-};
-
-class King : public Piece {
-public:
-    King(Colors color, Position pos);
-    bool isValidMove(Position start, Position end, const Board& board) const override;
-    string getName() const;
-    Pieces getType() const;
-    char getSymbol() const;
-};
+// Each function checks that a piece of the given color standing on start may move to end on this board.
+// Whether the move leaves the own king in check is not tested here. Piece::isValidMove picks the right one.
+bool isValidPawnMove(Colors color, Position start, Position end, const Board& board);
+bool isValidRookMove(Colors color, Position start, Position end, const Board& board);
+bool isValidKnightMove(Colors color, Position start, Position end, const Board& board);
+bool isValidBishopMove(Colors color, Position start, Position end, const Board& board);
+bool isValidQueenMove(Colors color, Position start, Position end, const Board& board);
+bool isValidKingMove(Colors color, Position start, Position end, const Board& board);
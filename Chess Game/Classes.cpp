@@ -7,12 +7,13 @@
 
 #include "Classes.h"
 #include "ChessPieces.h"
+#include "Evaluation.h"
+#include "Renderer.h"
+#include "Trace.h"
 #include <iostream>
+#include <algorithm>
 #include <cassert>
-
-// Constructor of Piece classs
-Piece::Piece(Colors color, Pieces name) : pieceColor(color), pieceName(name), hasMoved(false) {}
-Piece::Piece(Colors color, Pieces name, Position pos) : pieceColor(color), pieceName(name), position(pos), hasMoved(false) {}
+#include <cstring>
 
 // Implemetation of the == operator
 bool Position::operator==(const Position& other) const {
@@ -24,21 +25,6 @@ bool Position::operator!=(const Position& other) const {
 	return !(*this == other);
 }
 
-// Get the detail about a Piece if it made its first move
-bool Piece::getHasMoved() {
-	return Piece::hasMoved;
-}
-
-// Set that the Piece made its first move
-void Piece::setHasMoved(bool moved) {
-	hasMoved = moved;
-}
-
-// Get the color of the Piece
-Colors Piece::getColor() const {
-	return pieceColor;
-}
-
 // Define the operator<< overload for Colors
 ostream& operator<<(ostream& os, const Colors& color) {
 	switch (color) {
@@ -49,185 +35,486 @@ ostream& operator<<(ostream& os, const Colors& color) {
 	}
 }
 
-//Get the position of the Piece on the board
-Position Piece::getPosition() const {
-	return position;
-}
-
-void Piece::setPosition(const Position& newPosition) {
-    position = newPosition;
-}
-
 // Constructor - Initialize the board with random color assignments
 Board::Board() {
-    
-    // Initialize the board with nullptrs for empty spots
-    board = new Piece * *[8];
-    for (int i = 0; i < 8; i++) {
-        board[i] = new Piece * [8];
-        for (int j = 0; j < 8; j++) {
-            board[i][j] = nullptr;
-        }
-    }
+    clearBoard();
 
     // Set the white color to start at the bottom
     Colors rowColors[2] = { Colors::Black, Colors::White };
 
     // Setting up pawns and other pieces based on rowColors
     for (int i = 0; i < 8; i++) {
-        board[1][i] = new Pawn(rowColors[1], { 1, i });
-        board[6][i] = new Pawn(rowColors[0], { 6, i });
+        setPiece(squareIndex(1, i), Piece(rowColors[1], Pieces::Pawn));
+        setPiece(squareIndex(6, i), Piece(rowColors[0], Pieces::Pawn));
     }
 
     // Setting up Rooks
-    board[0][0] = new Rook(rowColors[1], { 0, 0 });
-    board[0][7] = new Rook(rowColors[1], { 0, 7 });
-       
-    board[7][0] = new Rook(rowColors[0], { 7, 0 });
-    board[7][7] = new Rook(rowColors[0], { 7, 7 });
+    setPiece(squareIndex(0, 0), Piece(rowColors[1], Pieces::Rook));
+    setPiece(squareIndex(0, 7), Piece(rowColors[1], Pieces::Rook));
+
+    setPiece(squareIndex(7, 0), Piece(rowColors[0], Pieces::Rook));
+    setPiece(squareIndex(7, 7), Piece(rowColors[0], Pieces::Rook));
 
     // Setting up Knights
-    board[0][1] = new Knight(rowColors[1], { 0, 1 });
-    board[0][6] = new Knight(rowColors[1], { 0, 6 });
-    
-    board[7][1] = new Knight(rowColors[0], { 7, 1 });
-    board[7][6] = new Knight(rowColors[0], { 7, 6 });
+    setPiece(squareIndex(0, 1), Piece(rowColors[1], Pieces::Knight));
+    setPiece(squareIndex(0, 6), Piece(rowColors[1], Pieces::Knight));
+
+    setPiece(squareIndex(7, 1), Piece(rowColors[0], Pieces::Knight));
+    setPiece(squareIndex(7, 6), Piece(rowColors[0], Pieces::Knight));
 
     // Setting up Bishops 
-    board[0][2] = new Bishop(rowColors[1], { 0, 2 });
-    board[0][5] = new Bishop(rowColors[1], { 0, 5 });
+    setPiece(squareIndex(0, 2), Piece(rowColors[1], Pieces::Bishop));
+    setPiece(squareIndex(0, 5), Piece(rowColors[1], Pieces::Bishop));
 
-    board[7][2] = new Bishop(rowColors[0], { 7, 2 });
-    board[7][5] = new Bishop(rowColors[0], { 7, 5 });
+    setPiece(squareIndex(7, 2), Piece(rowColors[0], Pieces::Bishop));
+    setPiece(squareIndex(7, 5), Piece(rowColors[0], Pieces::Bishop));
 
     // Setting up Queens
-    board[0][3] = new Queen(rowColors[1], { 0, 3 });
+    setPiece(squareIndex(0, 3), Piece(rowColors[1], Pieces::Queen));
 
-    board[7][3] = new Queen(rowColors[0], { 7, 3 });
+    setPiece(squareIndex(7, 3), Piece(rowColors[0], Pieces::Queen));
 
     // Setting up Kings
-    board[0][4] = new King(rowColors[1], { 0, 4 });
-    board[7][4] = new King(rowColors[0], { 7, 4 });
+    setPiece(squareIndex(0, 4), Piece(rowColors[1], Pieces::King));
+    setPiece(squareIndex(7, 4), Piece(rowColors[0], Pieces::King));
     whiteKingPosition = { 0, 4 };
     blackKingPosition = { 7, 4 };
 
+    // White to move with every castling right available
+    castlingRights = AllCastlingRights;
+    hashKey ^= Zobrist.castling[castlingRights];
+
+    // Compute the attacks of every piece once. Later moves only update what they change.
+    updateAttackMaps(~0ULL);
+    attackStats = AttackMapStats();
 }
 
-// Destructor
-Board::~Board() {
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            delete board[i][j];
-            board[i][j] = nullptr;  // Set pointer to nullptr
+// Empty the board and reset the game state: White to move, no castling rights, no history.
+// The history vectors keep their capacity, so loading a new position does not allocate.
+void Board::clearBoard() {
+    for (int color = 0; color < 2; color++) {
+        for (int type = 0; type < 7; type++) {
+            pieceBitboards[color][type] = 0;
+            pieceCounts[color][type] = 0;
         }
-        delete[] board[i];
-        board[i] = nullptr;  // Set pointer to nullptr
+        colorBitboards[color] = 0;
+        attackMaps[color] = 0;
+        bishopCounts[color][0] = bishopCounts[color][1] = 0;
+    }
+    occupied = 0;
+    movedPieces = 0;
+    for (int square = 0; square < 64; square++) {
+        squares[square] = Piece();
+        pieceAttacks[square] = 0;
     }
-    delete[] board;  // Deallocate the primary board array
+    sideToMove = Colors::White;
+    movesWithoutPawnOrCapture = 0;
+    fullMoveNumber = 1;
+    enPassantSquare = -1;
+    castlingRights = 0;
+    hashKey = 0;
+    middlegameScore = 0;
+    endgameScore = 0;
+    gamePhase = 0;
+    undoStack.clear();
+    keyHistory.clear();
+}
+
+// Build the board from a snapshot. Its moves cannot be taken back.
+Board::Board(const BoardSnapshot& snapshot) {
+    restoreSnapshot(snapshot);
+}
+
+// Copy the position into a snapshot, with the keys of the last positions for repetition detection
+void Board::saveSnapshot(BoardSnapshot& snapshot) const {
+    memcpy(snapshot.pieceBitboards, pieceBitboards, sizeof(pieceBitboards));
+    memcpy(snapshot.colorBitboards, colorBitboards, sizeof(colorBitboards));
+    snapshot.occupied = occupied;
+    snapshot.movedPieces = movedPieces;
+    memcpy(snapshot.pieceAttacks, pieceAttacks, sizeof(pieceAttacks));
+    memcpy(snapshot.attackMaps, attackMaps, sizeof(attackMaps));
+    snapshot.hashKey = hashKey;
+    memcpy(snapshot.squares, squares, sizeof(squares));
+    snapshot.whiteKingPosition = whiteKingPosition;
+    snapshot.blackKingPosition = blackKingPosition;
+    snapshot.sideToMove = sideToMove;
+    snapshot.movesWithoutPawnOrCapture = movesWithoutPawnOrCapture;
+    snapshot.fullMoveNumber = fullMoveNumber;
+    snapshot.enPassantSquare = enPassantSquare;
+    snapshot.castlingRights = castlingRights;
+    snapshot.middlegameScore = middlegameScore;
+    snapshot.endgameScore = endgameScore;
+    snapshot.gamePhase = gamePhase;
+    memcpy(snapshot.pieceCounts, pieceCounts, sizeof(pieceCounts));
+    memcpy(snapshot.bishopCounts, bishopCounts, sizeof(bishopCounts));
+    snapshot.historyLength = min(static_cast<int>(keyHistory.size()), SnapshotHistory);
+    copy(keyHistory.end() - snapshot.historyLength, keyHistory.end(), snapshot.keyHistory);
+}
+
+// Set the board to the position of a snapshot. The undo stack is emptied, so the moves that led to the
+// position cannot be taken back; moves played after it can.
+void Board::restoreSnapshot(const BoardSnapshot& snapshot) {
+    memcpy(pieceBitboards, snapshot.pieceBitboards, sizeof(pieceBitboards));
+    memcpy(colorBitboards, snapshot.colorBitboards, sizeof(colorBitboards));
+    occupied = snapshot.occupied;
+    movedPieces = snapshot.movedPieces;
+    memcpy(pieceAttacks, snapshot.pieceAttacks, sizeof(pieceAttacks));
+    memcpy(attackMaps, snapshot.attackMaps, sizeof(attackMaps));
+    hashKey = snapshot.hashKey;
+    memcpy(squares, snapshot.squares, sizeof(squares));
+    whiteKingPosition = snapshot.whiteKingPosition;
+    blackKingPosition = snapshot.blackKingPosition;
+    sideToMove = snapshot.sideToMove;
+    movesWithoutPawnOrCapture = snapshot.movesWithoutPawnOrCapture;
+    fullMoveNumber = snapshot.fullMoveNumber;
+    enPassantSquare = snapshot.enPassantSquare;
+    castlingRights = snapshot.castlingRights;
+    middlegameScore = snapshot.middlegameScore;
+    endgameScore = snapshot.endgameScore;
+    gamePhase = snapshot.gamePhase;
+    memcpy(pieceCounts, snapshot.pieceCounts, sizeof(pieceCounts));
+    memcpy(bishopCounts, snapshot.bishopCounts, sizeof(bishopCounts));
+    undoStack.clear();
+    keyHistory.assign(snapshot.keyHistory, snapshot.keyHistory + snapshot.historyLength);
 }
 
 
 // Print the board to the console
 void Board::printBoard() const {
-    // Define an array to store the labels for rows (1 to 8)
-    char rowLabels[8] = { '8', '7', '6', '5', '4', '3', '2', '1' };
-
-    for (int i = 7; i >= 0; i--) { // Start from 7 and go to 0
-        for (int j = 0; j < 8; j++) {
-            if (board[i][j]) { // Check if not nullptr
-                cout << "[" << board[i][j]->getSymbol() << ", " << static_cast<char>('a' + j) << rowLabels[i] << "] ";
-            }
-            else {
-                cout << "[   " << static_cast<char>('a' + j) << rowLabels[i] << "] ";
-            }
-        }
-        cout << endl; // Row label (again)
-    }
+    // The whole board is built in a buffer and written at once
+    BoardRenderer renderer;
+    renderer.render(*this, cout);
 }
 
 
 // Get the Piece at the position - pos if exist 
-Piece* Board::getPieceAt(Position pos) const {
+Piece Board::getPieceAt(Position pos) const {
 	if (pos.row >= 0 && pos.row < 8 && pos.col >= 0 && pos.col < 8) {
-		return board[pos.row][pos.col];
+		return squares[squareIndex(pos)];
 	}
-	return nullptr;  // Position is out of bounds
+	return Piece();  // Position is out of bounds
+}
+
+// Check if the piece at the position has moved since the start of the game
+bool Board::hasPieceMoved(Position pos) const {
+    return (movedPieces & squareBit(squareIndex(pos))) != 0;
 }
 
 // Place a piece at a specific location without checking anything
-void Board::placePieceAt(const Position& position, Piece* piece) {
-    board[position.row][position.col] = piece;
+void Board::placePieceAt(const Position& position, Piece piece) {
+    int square = squareIndex(position);
+    clearSquare(square);
+    if (piece) {
+        setPiece(square, piece);
+    }
+    updateAttackMaps(squareBit(square));
+}
+
+// Put a piece on an empty square and add it to the bitboards
+void Board::setPiece(int square, Piece piece) {
+    Bitboard bit = squareBit(square);
+    int color = colorIndex(piece.getColor());
+    squares[square] = piece;
+    pieceBitboards[color][static_cast<int>(piece.getType())] |= bit;
+    colorBitboards[color] |= bit;
+    occupied |= bit;
+    hashKey ^= Zobrist.pieceSquare[color][static_cast<int>(piece.getType())][square];
+    middlegameScore += PieceSquare.middlegame[color][static_cast<int>(piece.getType())][square];
+    endgameScore += PieceSquare.endgame[color][static_cast<int>(piece.getType())][square];
+    gamePhase += PieceSquare.phase[static_cast<int>(piece.getType())];
+    pieceCounts[color][static_cast<int>(piece.getType())]++;
+    if (piece.getType() == Pieces::Bishop) {
+        bishopCounts[color][(square / 8 + square % 8) & 1]++;
+    }
+}
+
+// Take the piece off a square and out of the bitboards. Returns the removed piece (empty if there was none).
+Piece Board::clearSquare(int square) {
+    Piece piece = squares[square];
+    if (piece) {
+        Bitboard bit = squareBit(square);
+        int color = colorIndex(piece.getColor());
+        pieceBitboards[color][static_cast<int>(piece.getType())] &= ~bit;
+        colorBitboards[color] &= ~bit;
+        occupied &= ~bit;
+        movedPieces &= ~bit;
+        squares[square] = Piece();
+        hashKey ^= Zobrist.pieceSquare[color][static_cast<int>(piece.getType())][square];
+        middlegameScore -= PieceSquare.middlegame[color][static_cast<int>(piece.getType())][square];
+        endgameScore -= PieceSquare.endgame[color][static_cast<int>(piece.getType())][square];
+        gamePhase -= PieceSquare.phase[static_cast<int>(piece.getType())];
+        pieceCounts[color][static_cast<int>(piece.getType())]--;
+        if (piece.getType() == Pieces::Bishop) {
+            bishopCounts[color][(square / 8 + square % 8) & 1]--;
+        }
+    }
+    return piece;
 }
 
 // Check if there is an opponent on the position pos
 bool Board::isOpponentAt(Position pos, Colors color) const {
-	Piece* pieceAtPos = getPieceAt(pos);
-	if (pieceAtPos == nullptr) {
-		return false; // No piece at the given position
+	if (pos.row < 0 || pos.row >= 8 || pos.col < 0 || pos.col >= 8) {
+		return false; // Position is out of bounds
 	}
-	Colors pieceColor = pieceAtPos->getColor();
-	// Return true if the colors are different and neither is Colors::Empty
-	return pieceColor != color && pieceColor != Colors::Empty;
+	// Every piece is an opponent of Colors::Empty, otherwise only pieces of the other color are
+	Bitboard opponents = (color == Colors::Empty) ? occupied : colorBitboards[colorIndex(oppositeColor(color))];
+	return (opponents & squareBit(squareIndex(pos))) != 0;
+}
+
+// Get all pieces of attackerColor that attack the square
+Bitboard Board::attackersTo(int square, Colors attackerColor, Bitboard occupancy) const {
+    const Bitboard* pieces = pieceBitboards[colorIndex(attackerColor)];
+    Bitboard rooksAndQueens = pieces[static_cast<int>(Pieces::Rook)] | pieces[static_cast<int>(Pieces::Queen)];
+    Bitboard bishopsAndQueens = pieces[static_cast<int>(Pieces::Bishop)] | pieces[static_cast<int>(Pieces::Queen)];
+
+    // A pawn attacks the square exactly when a pawn of the other color on that square would attack the pawn
+    return (PawnAttacks[colorIndex(oppositeColor(attackerColor))][square] & pieces[static_cast<int>(Pieces::Pawn)])
+        | (KnightAttacks[square] & pieces[static_cast<int>(Pieces::Knight)])
+        | (KingAttacks[square] & pieces[static_cast<int>(Pieces::King)])
+        | (rookAttacks(square, occupancy) & rooksAndQueens)
+        | (bishopAttacks(square, occupancy) & bishopsAndQueens);
+}
+
+// Get the squares attacked by the piece on the square, given the current occupancy
+Bitboard Board::attacksFrom(int square) const {
+    Piece piece = squares[square];
+    switch (piece.getType()) {
+    case Pieces::Pawn: return PawnAttacks[colorIndex(piece.getColor())][square];
+    case Pieces::Knight: return KnightAttacks[square];
+    case Pieces::Bishop: return bishopAttacks(square, occupied);
+    case Pieces::Rook: return rookAttacks(square, occupied);
+    case Pieces::Queen: return queenAttacks(square, occupied);
+    case Pieces::King: return KingAttacks[square];
+    default: return 0;
+    }
 }
 
-bool Board::movePiece(const Position& start, const Position& end, bool isSimulation) {
-    Piece* piece = getPieceAt(start);
+// Bring the attack maps up to date after the pieces on changedSquares were added, removed or moved.
+// Only two kinds of pieces can attack differently: the ones standing on a changed square, and the sliders
+// whose attacks reached a changed square (a blocker appeared or disappeared on their ray). Every other
+// slider's ray stops at a blocker before any changed square, so its attacks stay the same.
+void Board::updateAttackMaps(Bitboard changedSquares) {
+    Bitboard sliders = pieceBitboards[0][static_cast<int>(Pieces::Bishop)] | pieceBitboards[0][static_cast<int>(Pieces::Rook)]
+        | pieceBitboards[0][static_cast<int>(Pieces::Queen)] | pieceBitboards[1][static_cast<int>(Pieces::Bishop)]
+        | pieceBitboards[1][static_cast<int>(Pieces::Rook)] | pieceBitboards[1][static_cast<int>(Pieces::Queen)];
+    Bitboard recompute = changedSquares;
+    Bitboard unchangedSliders = sliders & ~changedSquares;
+    while (unchangedSliders) {
+        int square = popLowestSquare(unchangedSliders);
+        if (pieceAttacks[square] & changedSquares) {
+            recompute |= squareBit(square);
+        }
+    }
+
+    attackStats.updates++;
+    while (recompute) {
+        int square = popLowestSquare(recompute);
+        pieceAttacks[square] = attacksFrom(square);
+        attackStats.squaresRecomputed++;
+    }
+
+    for (int color = 0; color < 2; color++) {
+        attackMaps[color] = 0;
+        Bitboard pieces = colorBitboards[color];
+        while (pieces) {
+            attackMaps[color] |= pieceAttacks[popLowestSquare(pieces)];
+        }
+    }
+}
+
+// Check if pos is the square a pawn skipped with a double move on the last move
+bool Board::isEnPassantAt(Position pos) const {
+    return enPassantSquare >= 0 && squareIndex(pos) == enPassantSquare;
+}
+
+// Validate a move with the rules of the moving piece and play it. The move can be taken back with unmakeMove.
+bool Board::movePiece(const Position& start, const Position& end, Pieces promotion) {
+    Piece piece = getPieceAt(start);
     if (!piece)
         return false; // If there's no piece at the start position, can't move.
 
     // If the move is valid
-    if (piece->isValidMove(start, end, *this)) {
-        // Handle castling move
-        if (piece->getType() == Pieces::King && abs(start.col - end.col) == 2) { // try to move the king 2 steps - castling
-            if (end.col == 6) { // kingside
-                Piece* kingsideRook = getPieceAt({ start.row, 7 });
-                board[start.row][5] = kingsideRook;  // Move rook to f1/f8
-                board[start.row][7] = nullptr;       // Clear original rook position
-                kingsideRook->setPosition({ start.row, 5 });
-            }
-            else { // queenside
-                Piece* queensideRook = getPieceAt({ start.row, 0 });
-                board[start.row][3] = queensideRook;  // Move rook to d1/d8
-                board[start.row][0] = nullptr;        // Clear original rook position
-                queensideRook->setPosition({ start.row, 3 });
-            }
-        }
+    if (piece.isValidMove(start, end, *this)) {
+        makeMove(createMove(start, end, promotion));
+        return true;
+    }
+    return false;
+}
 
-        Piece* destinationPiece = getPieceAt(end);
-        if (destinationPiece && !isSimulation) {
-            delete destinationPiece;  // Ensure any captured piece is deleted only if it's not a simulation.
-            movesWithoutPawnOrCapture = 0;
-        }
-        else if (typeid(*piece) == typeid(Pawn)) {
-            movesWithoutPawnOrCapture = 0;
+// Describe the move of the piece at start to end, with the flags makeMove needs
+Move Board::createMove(const Position& start, const Position& end, Pieces promotion) const {
+    Piece piece = getPieceAt(start);
+    uint8_t flags = squares[squareIndex(end)] ? CaptureFlag : 0;
+    bool isPawn = piece.getType() == Pieces::Pawn;
+
+    if (isPawn && !flags && start.col != end.col && isEnPassantAt(end)) {
+        flags = CaptureFlag | EnPassantFlag; // A pawn moving diagonally to the en passant square
+    }
+    else if (isPawn && abs(end.row - start.row) == 2) {
+        flags = DoublePushFlag;
+    }
+    else if (piece.getType() == Pieces::King && abs(start.col - end.col) == 2) {
+        flags = CastlingFlag; // try to move the king 2 steps - castling
+    }
+    if (!isPawn || (end.row != 0 && end.row != 7)) {
+        promotion = Pieces::None;
+    }
+    return { static_cast<uint8_t>(squareIndex(start)), static_cast<uint8_t>(squareIndex(end)), promotion, flags };
+}
+
+// Castling rights that survive a move from or to the given square. A king or rook leaving its starting
+// square, or a rook captured on it, loses the rights that depend on that piece.
+static int castlingRightsKept(int square) {
+    switch (square) {
+    case 0: return AllCastlingRights & ~WhiteQueenside;                    // a1
+    case 4: return AllCastlingRights & ~(WhiteKingside | WhiteQueenside);  // e1
+    case 7: return AllCastlingRights & ~WhiteKingside;                     // h1
+    case 56: return AllCastlingRights & ~BlackQueenside;                   // a8
+    case 60: return AllCastlingRights & ~(BlackKingside | BlackQueenside); // e8
+    case 63: return AllCastlingRights & ~BlackKingside;                    // h8
+    default: return AllCastlingRights;
+    }
+}
+
+// Squares whose contents change when the move is played or taken back
+static Bitboard changedSquares(const Move& move) {
+    Bitboard changed = squareBit(move.from) | squareBit(move.to);
+    if (move.flags & EnPassantFlag) {
+        changed |= squareBit(squareIndex(move.from / 8, move.to % 8)); // The captured pawn
+    }
+    else if (move.flags & CastlingFlag) {
+        int row = move.from / 8;
+        bool kingside = move.to % 8 == 6;
+        changed |= squareBit(squareIndex(row, kingside ? 7 : 0)) | squareBit(squareIndex(row, kingside ? 5 : 3));
+    }
+    return changed;
+}
+
+// Play a move without validating it and push what is needed to take it back onto the undo stack
+void Board::makeMove(const Move& move) {
+    Piece piece = squares[move.from];
+    bool isPawn = piece.getType() == Pieces::Pawn;
+    Position start = squarePosition(move.from);
+    Position end = squarePosition(move.to);
+
+    UndoRecord record;
+    record.move = move;
+    record.enPassantSquare = enPassantSquare;
+    record.movesWithoutPawnOrCapture = movesWithoutPawnOrCapture;
+    record.castlingRights = castlingRights;
+    record.hashKey = hashKey;
+    record.whiteKingPosition = whiteKingPosition;
+    record.blackKingPosition = blackKingPosition;
+    record.movedPieces = movedPieces;
+
+    // Take the captured piece off the board, remembering it in the undo record
+    if (move.flags & EnPassantFlag) {
+        record.capturedPiece = clearSquare(squareIndex(start.row, end.col)); // The pawn that skipped the end square
+    }
+    else if (move.flags & CaptureFlag) {
+        record.capturedPiece = clearSquare(move.to);
+    }
+
+    // Handle castling move
+    if (move.flags & CastlingFlag) {
+        bool kingside = end.col == 6;
+        int rookSquare = squareIndex(start.row, kingside ? 5 : 3);
+        setPiece(rookSquare, clearSquare(squareIndex(start.row, kingside ? 7 : 0))); // Move rook to f1/f8 or d1/d8
+        movedPieces |= squareBit(rookSquare);
+    }
+
+    // Execute the move, replacing a pawn that reached the last row with the promoted piece
+    clearSquare(move.from);
+    setPiece(move.to, (move.promotion != Pieces::None) ? Piece(piece.getColor(), move.promotion) : piece);
+    movedPieces |= squareBit(move.to);
+
+    if (record.capturedPiece || isPawn) {
+        movesWithoutPawnOrCapture = 0;
+    }
+    else {
+        movesWithoutPawnOrCapture++;
+    }
+
+    // Update king position if a king is moved
+    if (piece.getType() == Pieces::King) {
+        if (piece.getColor() == Colors::White) {
+            whiteKingPosition = end;
         }
         else {
-            movesWithoutPawnOrCapture++;
+            blackKingPosition = end;
         }
+    }
 
-        // Execute the move
-        board[end.row][end.col] = piece;
-        board[start.row][start.col] = nullptr;
-        piece->setPosition(end);
+    hashKey ^= Zobrist.castling[castlingRights];
+    castlingRights &= castlingRightsKept(move.from) & castlingRightsKept(move.to);
+    hashKey ^= Zobrist.castling[castlingRights];
 
-        // Update king position if a king is moved
-        if (piece->getType() == Pieces::King) {
-            if (piece->getColor() == Colors::White) {
-                whiteKingPosition = end;
-            }
-            else {
-                blackKingPosition = end;
-            }
+    // Remember the skipped square after a pawn double move, if an opponent pawn can capture en passant there
+    if (enPassantSquare >= 0) {
+        hashKey ^= Zobrist.enPassantFile[enPassantSquare % 8];
+    }
+    enPassantSquare = -1;
+    if (move.flags & DoublePushFlag) {
+        int skippedSquare = (move.from + move.to) / 2;
+        Colors opponent = oppositeColor(piece.getColor());
+        if (PawnAttacks[colorIndex(piece.getColor())][skippedSquare] & pieceBitboards[colorIndex(opponent)][static_cast<int>(Pieces::Pawn)]) {
+            enPassantSquare = skippedSquare;
+            hashKey ^= Zobrist.enPassantFile[enPassantSquare % 8];
         }
+    }
 
-        // Update the first move of the piece
-        if (!piece->getHasMoved()) {
-            piece->setHasMoved(true);
-        }
+    if (sideToMove == Colors::Black) {
+        fullMoveNumber++;
+    }
+    sideToMove = oppositeColor(sideToMove);
+    hashKey ^= Zobrist.blackToMove;
 
-        return true;
+    updateAttackMaps(changedSquares(move));
+
+    undoStack.push_back(record);
+    keyHistory.push_back(record.hashKey);
+}
+
+// Take back the last move played with makeMove or movePiece
+void Board::unmakeMove() {
+    if (undoStack.empty()) {
+        return;
     }
-    return false;
+    UndoRecord record = undoStack.back();
+    undoStack.pop_back();
+    keyHistory.pop_back();
+    const Move& move = record.move;
+    Position start = squarePosition(move.from);
+    Position end = squarePosition(move.to);
+
+    // Put the moving piece back, replacing a promoted piece with its pawn
+    Piece piece = clearSquare(move.to);
+    setPiece(move.from, (move.promotion != Pieces::None) ? Piece(piece.getColor(), Pieces::Pawn) : piece);
+
+    // Put the rook back in its corner
+    if (move.flags & CastlingFlag) {
+        bool kingside = end.col == 6;
+        setPiece(squareIndex(start.row, kingside ? 7 : 0), clearSquare(squareIndex(start.row, kingside ? 5 : 3)));
+    }
+
+    // Put the captured piece back where it was taken
+    if (record.capturedPiece) {
+        setPiece((move.flags & EnPassantFlag) ? squareIndex(start.row, end.col) : move.to, record.capturedPiece);
+    }
+
+    enPassantSquare = record.enPassantSquare;
+    movesWithoutPawnOrCapture = record.movesWithoutPawnOrCapture;
+    castlingRights = record.castlingRights;
+    hashKey = record.hashKey; // Restores the piece-square part too, after setPiece/clearSquare above
+    sideToMove = oppositeColor(sideToMove);
+    if (sideToMove == Colors::Black) {
+        fullMoveNumber--;
+    }
+    whiteKingPosition = record.whiteKingPosition;
+    blackKingPosition = record.blackKingPosition;
+    movedPieces = record.movedPieces;
+
+    updateAttackMaps(changedSquares(move));
 }
 
 
@@ -243,167 +530,182 @@ bool Board::isInCheck(Colors kingColor) const {
     else {
         kingPosition = blackKingPosition;
     }
-    // Iterate through all opponent pieces
-    for (int row = 0; row < 8; row++) {
-        for (int col = 0; col < 8; col++) {
-            Piece* piece = board[row][col];
-            if (piece && piece->getColor() != kingColor) {
-                // Check if this piece can attack the king's position
-                if (piece->isValidMove(piece->getPosition(), kingPosition, *this)) {
-                    // King is in check
-                    cout << piece->getName() << " at [" << piece->getPosition().row << ", " << piece->getPosition().col
-                        << "] threatens King at [" << kingPosition.row << ", " << kingPosition.col << "]" << endl;
-                    return true;
-                }
-            }
-        }
+    // Test the king's square against the squares the opponent attacks
+    int kingSquare = squareIndex(kingPosition);
+    Colors opponent = oppositeColor(kingColor);
+    TRACE_EVENT(TraceEvent::CheckScan, Pieces::King, kingSquare, NoTraceSquare);
+    if (attackMaps[colorIndex(opponent)] & squareBit(kingSquare)) {
+        // King is in check. The checking piece is only looked up for the trace.
+#ifdef CHESS_TRACE
+        int checkerSquare = lowestSquare(attackersTo(kingSquare, opponent, occupied));
+        TRACE_EVENT(TraceEvent::CheckFound, squares[checkerSquare].getType(), checkerSquare, kingSquare);
+#endif
+        return true;
     }
     // King is not in check
     return false;
 }
 
-bool Board::isCheckMate(Colors playerColor) {
+bool Board::isCheckMate(Colors playerColor, int legalMoveCount) const {
     // Step 1: Check if the player's king is in check
     if (!isInCheck(playerColor)) {
         return false;  // The king is not in check, so it's not checkmate
     }
 
-    // Get the king's position based on the color
-    Position kingPosition = (playerColor == Colors::White) ? whiteKingPosition : blackKingPosition;
-
-    // Step 2: Check if King can move to a safe square
-    static const Position directions[8] = { {1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {-1,-1}, {1,-1}, {-1,1} };
-    for (const Position& dir : directions) {
-        Position newPos = { kingPosition.row + dir.row, kingPosition.col + dir.col };
-        if (newPos.row >= 0 && newPos.row < 8 && newPos.col >= 0 && newPos.col < 8) {
-            Piece* temp = board[newPos.row][newPos.col];
-            movePiece(kingPosition, newPos, true);
-            bool stillInCheck = isInCheck(playerColor);
-            movePiece(newPos, kingPosition, true); // Revert the move
-            board[newPos.row][newPos.col] = temp; // Restore any captured piece
-            if (!stillInCheck) {
-                return false; // Found a safe square for the king
-            }
-        }
-    }
-
-    // Step 3 & 4: Check other pieces if they can block the check or capture the threatening piece
-    for (int i = 0; i < 8; i++) {
-        for (int j = 0; j < 8; j++) {
-            Position start = { i, j };
-            Piece* piece = getPieceAt(start);
-            if (piece && piece->getColor() == playerColor) {
-                for (int x = 0; x < 8; x++) {
-                    for (int y = 0; y < 8; y++) {
-                        Position end = { x, y };
-                        Piece* originalPieceAtStart = getPieceAt(start);
-                        Piece* originalPieceAtEnd = getPieceAt(end);  // Store the piece at the destination
-
-                        if (piece->isValidMove(start, end, *this)) {
-                            movePiece(start, end, true); // Simulated move
-                            bool stillInCheck = isInCheck(playerColor);
-                            movePiece(end, start, true); // Revert the move
-
-                            // Restore the board to its original state
-                            board[start.row][start.col] = originalPieceAtStart;
-                            board[end.row][end.col] = originalPieceAtEnd;
-
-                            if (!stillInCheck) {
-                                return false; // Found a move that breaks the check
-                            }
-                        }
-
-
-                    }
-                }
-            }
-        }
+    // Step 2: Any legal move (king step, block or capture of the checking piece) breaks the check
+    if (legalMoveCount < 0) {
+        legalMoveCount = generateLegalMoves(playerColor).count;
     }
-    // If no moves found that can break the check, it's checkmate
-    return true;
+    return legalMoveCount == 0;
 }
 
         
-    bool Board::isDraw(Colors currentPlayer) const {
-        // Check for conditions that can lead to a draw
-        if (!isInCheck(currentPlayer)) {
-            // Check for stalemate (no legal moves available)
-            for (int row = 0; row < 8; row++) {
-                for (int col = 0; col < 8; col++) {
-                    Piece* piece = board[row][col];
-                    if (piece && piece->getColor() == currentPlayer) {
-                        for (int newRow = 0; newRow < 8; newRow++) {
-                            for (int newCol = 0; newCol < 8; newCol++) {
-                                Position start = { row, col };
-                                Position end = { newRow, newCol };
-                                if (piece->isValidMove(start, end, *this)) {
-                                    // There's a legal move for the current player
-                                    return false;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            // No legal moves available, it's a stalemate
+    // The rules that only look at counters come first; the legal moves are generated only if the caller did not
+    // pass their count and no other rule applies
+    bool Board::isDraw(Colors currentPlayer, int legalMoveCount) const {
+        // Fifty-Move Rule: fifty moves by each player, counted in plies
+        if (movesWithoutPawnOrCapture >= 100) {
+            return true;
+        }
+
+        if (isInsufficientMaterial()) {
             return true;
         }
-       
-        // Fifty-Move Rule:
-        if (movesWithoutPawnOrCapture >= 50) {
+
+        // Threefold repetition:
+        if (isThreefoldRepetition()) {
             return true;
         }
 
-        // Insufficient Material:
-        // Check the board for specific combinations like K vs K, K vs KB, K vs KN
-        int numWhiteBishops = 0, numWhiteKnights = 0, numBlackBishops = 0, numBlackKnights = 0;
-        int numWhiteBishopsLightSquare = 0, numWhiteBishopsDarkSquare = 0;
-        int numBlackBishopsLightSquare = 0, numBlackBishopsDarkSquare = 0;
-
-        for (int row = 0; row < 8; row++) {
-            for (int col = 0; col < 8; col++) {
-                Piece* piece = board[row][col];
-                if (piece) {
-                    if (piece->getColor() == Colors::White) {
-                        if (typeid(*piece) == typeid(Bishop)) {
-                            (row + col) % 2 == 0 ? numWhiteBishopsLightSquare++ : numWhiteBishopsDarkSquare++;
-                        }
-                    }
-                    else if (piece->getColor() == Colors::Black) {
-                        if (typeid(*piece) == typeid(Bishop)) {
-                            (row + col) % 2 == 0 ? numBlackBishopsLightSquare++ : numBlackBishopsDarkSquare++;
-                        }
-                    }
-                }
+        // Check for stalemate: the player is not in check and has no legal moves available
+        if (legalMoveCount < 0) {
+            legalMoveCount = generateLegalMoves(currentPlayer).count;
+        }
+        return legalMoveCount == 0 && !isInCheck(currentPlayer);
+    }
+
+    // Check if neither side has enough material left to checkmate, from the piece counts
+    bool Board::isInsufficientMaterial() const {
+        // Insufficient material is only possible once all pawns, rooks and queens are off the board
+        for (int color = 0; color < 2; color++) {
+            if (pieceCounts[color][static_cast<int>(Pieces::Pawn)] + pieceCounts[color][static_cast<int>(Pieces::Rook)]
+                + pieceCounts[color][static_cast<int>(Pieces::Queen)] > 0) {
+                return false;
             }
         }
 
-        // Handle the four cases of insufficient material
-        if (
-            (numWhiteBishopsLightSquare + numWhiteBishopsDarkSquare + numBlackBishopsLightSquare + numBlackBishopsDarkSquare + numWhiteKnights + numBlackKnights == 0) || // K vs K
-            (numWhiteBishopsLightSquare + numWhiteBishopsDarkSquare + numBlackBishopsLightSquare + numBlackKnights + numWhiteKnights == 1 && numBlackBishopsDarkSquare == 0) || // K vs K and (B or N)
-            (numBlackBishopsLightSquare + numBlackBishopsDarkSquare + numWhiteBishopsLightSquare + numWhiteKnights + numBlackKnights == 1 && numWhiteBishopsDarkSquare == 0) || // K vs K and (B or N)
-            (numWhiteBishopsLightSquare == 1 && numBlackBishopsLightSquare == 1) || // K and B vs K and B (both on light square)
-            (numWhiteBishopsDarkSquare == 1 && numBlackBishopsDarkSquare == 1) // K and B vs K and B (both on dark square)
-            ) {
+        int knights = pieceCounts[0][static_cast<int>(Pieces::Knight)] + pieceCounts[1][static_cast<int>(Pieces::Knight)];
+        int darkBishops = bishopCounts[0][0] + bishopCounts[1][0];
+        int lightBishops = bishopCounts[0][1] + bishopCounts[1][1];
+
+        // K vs K, and K vs K and a single bishop or knight
+        if (knights + darkBishops + lightBishops <= 1) {
             return true;
         }
+        // Only bishops, all on squares of one color (such as K and B vs K and B on the same color): none of
+        // them can ever attack the other color, where the king would have to stand to be mated
+        return knights == 0 && (darkBishops == 0 || lightBishops == 0);
+    }
+
 
-        return false; // Default case, not a draw
+    // How the game stands for the side to move: over by checkmate or one of the draw rules, or still going.
+    // Callers that already generated the legal moves of the side to move pass their count.
+    GameEnd Board::getGameEnd(int legalMoveCount) const {
+        if (legalMoveCount < 0) {
+            legalMoveCount = generateLegalMoves(sideToMove).count;
+        }
+        if (legalMoveCount == 0) {
+            return isInCheck(sideToMove) ? GameEnd::Checkmate : GameEnd::Stalemate;
+        }
+        if (movesWithoutPawnOrCapture >= 100) {
+            return GameEnd::FiftyMoveRule;
+        }
+        if (isThreefoldRepetition()) {
+            return GameEnd::ThreefoldRepetition;
+        }
+        if (isInsufficientMaterial()) {
+            return GameEnd::InsufficientMaterial;
+        }
+        return GameEnd::None;
+    }
+
+    // Check if the current position has occurred three times with the same player to move, castling rights
+    // and en passant square. Only positions since the last pawn move or capture can repeat, and only every
+    // second one has the same player to move.
+    bool Board::isThreefoldRepetition() const {
+        return countRepetitions(2) >= 2;
+    }
+
+    // Count the earlier occurrences of the current position, stopping once the limit is reached
+    int Board::countRepetitions(int limit) const {
+        int count = 0;
+        int reachable = min(movesWithoutPawnOrCapture, static_cast<int>(keyHistory.size()));
+        for (int back = 2; back <= reachable; back += 2) {
+            if (keyHistory[keyHistory.size() - back] == hashKey && ++count == limit) {
+                break;
+            }
+        }
+        return count;
+    }
+
+    uint64_t Board::getHashKey() const {
+        return hashKey;
+    }
+
+    Colors Board::getSideToMove() const {
+        return sideToMove;
+    }
+
+    Bitboard Board::getOccupied() const {
+        return occupied;
+    }
+
+    Bitboard Board::getPiecesOf(Colors color) const {
+        return colorBitboards[colorIndex(color)];
+    }
+
+    Bitboard Board::getPieces(Colors color, Pieces type) const {
+        return pieceBitboards[colorIndex(color)][static_cast<int>(type)];
+    }
+
+    int Board::getHalfmoveClock() const {
+        return movesWithoutPawnOrCapture;
+    }
+
+    // Static evaluation in centipawns from the point of view of the side to move: material and piece-square
+    // values, blended between the middlegame and the endgame by the material left
+    int Board::getEvaluation() const {
+        int score = taperedScore(middlegameScore, endgameScore, gamePhase);
+        return (sideToMove == Colors::White) ? score : -score;
+    }
+
+    int Board::getFullMoveNumber() const {
+        return fullMoveNumber;
+    }
+
+    int Board::getCastlingRights() const {
+        return castlingRights;
+    }
+
+    // Square a pawn can be captured on en passant, -1 if none
+    int Board::getEnPassantSquare() const {
+        return enPassantSquare;
+    }
+
+    // Squares attacked by the pieces of the given color
+    Bitboard Board::getAttackMap(Colors color) const {
+        return attackMaps[colorIndex(color)];
+    }
+
+    AttackMapStats Board::getAttackMapStats() const {
+        return attackStats;
     }
 
 
     // Check if specific position in the board is uncer attack.
     bool Board::isUnderAttack(Colors color, Position position) const {
-        for (int row = 0; row < 8; row++) {
-            for (int col = 0; col < 8; col++) {
-                Piece* piece = board[row][col];
-                if (piece && piece->getColor() != color) {
-                    if (piece->isValidMove({ row,col }, position, *this)) {
-                        return true;  // The position is under attack.
-                    }
-                }
-            }
+        if (attackMaps[colorIndex(oppositeColor(color))] & squareBit(squareIndex(position))) {
+            return true;  // The position is under attack.
         }
         return false;  // The position is not under attack.
     }
@@ -414,39 +716,43 @@ bool Board::isCheckMate(Colors playerColor) {
         Colors kingColor = (kingStart.row == 0) ? Colors::White : Colors::Black;
 
         // Get the king and rook pieces based on the start positions
-        Piece* king = getPieceAt(kingStart);
-        Piece* rook = nullptr;
+        Piece king = getPieceAt(kingStart);
+        Piece rook;
+        int rookCol;
 
         // Ensure the king is actually King
-        if (!king || king->getType() != Pieces::King) {
+        if (!king || king.getType() != Pieces::King) {
             return false;
         }
 
         // Check direction of castling (kingside or queenside) based on column movement
         if (kingEnd.col == 6) { // Kingside
-            rook = getPieceAt({ kingStart.row, 7 });
+            rookCol = 7;
         }
         else if (kingEnd.col == 2) { // Queenside
-            rook = getPieceAt({ kingStart.row, 0 });
+            rookCol = 0;
         }
         else {
             return false; // Invalid column for castling
         }
+        rook = getPieceAt({ kingStart.row, rookCol });
 
         // Ensure the king and rook are the correct types and colors
-        if (!king || king->getType() != Pieces::King || king->getColor() != kingColor ||
-            !rook || rook->getType() != Pieces::Rook || rook->getColor() != kingColor) {
+        if (!king || king.getType() != Pieces::King || king.getColor() != kingColor ||
+            !rook || rook.getType() != Pieces::Rook || rook.getColor() != kingColor) {
             return false;
         }
 
-        // Check if the king or rook has moved before
-        if (king->getHasMoved() || rook->getHasMoved()) {
+        // Check that the right to castle on this side has not been lost by moving the king or rook
+        int right = (kingColor == Colors::White) ? (kingEnd.col == 6 ? WhiteKingside : WhiteQueenside)
+                                                 : (kingEnd.col == 6 ? BlackKingside : BlackQueenside);
+        if (!(castlingRights & right)) {
             return false;
         }
 
         // Ensure all squares between the king and rook are empty
-        int startCol = min(kingStart.col, rook->getPosition().col);
-        int endCol = max(kingStart.col, rook->getPosition().col);
+        int startCol = min(kingStart.col, rookCol);
+        int endCol = max(kingStart.col, rookCol);
         for (int col = startCol + 1; col < endCol; col++) {
             if (getPieceAt({ kingStart.row, col })) {
                 return false;
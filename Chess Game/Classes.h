@@ -9,14 +9,18 @@
 
 #include <string>
 #include <iostream>
-#include <map>
 #include <sstream>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+#include "Bitboard.h"
+#include "Zobrist.h"
 
 using namespace std;
 
 // Define enums
 enum class Colors { Empty, Black, White };
-enum class Pieces { None, Pawn, Knight, Bishop, Rook, Queen, King };
+enum class Pieces : uint8_t { None, Pawn, Knight, Bishop, Rook, Queen, King };
 
 // Declare the operator<< overload (without defining it here)
 ostream& operator<<(ostream& os, const Colors& color);
@@ -32,53 +36,228 @@ struct Position {
     bool operator!=(const Position& other) const;
 };
 
+// Convert between board positions and bitboard square indexes
+inline int squareIndex(Position pos) {
+    return squareIndex(pos.row, pos.col);
+}
+
+inline Position squarePosition(int square) {
+    return Position(square / 8, square % 8);
+}
+
+// Index used for per-color arrays: 0 for White, 1 for Black
+inline int colorIndex(Colors color) {
+    return (color == Colors::White) ? 0 : 1;
+}
+
+inline Colors oppositeColor(Colors color) {
+    return (color == Colors::White) ? Colors::Black : Colors::White;
+}
+
+// Flags describing a Move
+const uint8_t CaptureFlag = 1;
+const uint8_t DoublePushFlag = 2;
+const uint8_t EnPassantFlag = 4;
+const uint8_t CastlingFlag = 8;
+
+// A move as produced by the move generator, using square indexes (row * 8 + col)
+struct Move {
+    uint8_t from;
+    uint8_t to;
+    Pieces promotion; // The piece a pawn promotes to, Pieces::None for every other move
+    uint8_t flags;
+
+    Position getStart() const { return squarePosition(from); }
+    Position getEnd() const { return squarePosition(to); }
+};
+
+// Fixed-capacity move list that lives on the stack. No position has more than 218 legal moves.
+const int MaxMoves = 256;
+
+struct MoveList {
+    Move moves[MaxMoves];
+    int count = 0;
+
+    void add(int from, int to, uint8_t flags, Pieces promotion = Pieces::None) {
+        moves[count++] = { static_cast<uint8_t>(from), static_cast<uint8_t>(to), promotion, flags };
+    }
+    const Move& operator[](int index) const { return moves[index]; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + count; }
+
+    // Find the move from start to end. Promotions are generated queen first, so a plain
+    // "e7 to e8" request finds the queen promotion.
+    const Move* find(const Position& start, const Position& end) const;
+};
+
+// Standard starting position, and a buffer size that holds any FEN written by Board::toFEN
+const char* const StartFEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+const int FENBufferSize = 128;
+
+// Ways a game can end, apart from resignation and time
+enum class GameEnd { None, Checkmate, Stalemate, FiftyMoveRule, ThreefoldRepetition, InsufficientMaterial };
+
+// Castling rights, one bit per king and side
+const int WhiteKingside = 1;
+const int WhiteQueenside = 2;
+const int BlackKingside = 4;
+const int BlackQueenside = 8;
+const int AllCastlingRights = 15;
+
 // Forward declaration
 class Board;
 
+// Counters of the incremental attack map updates
+struct AttackMapStats {
+    uint64_t updates = 0;           // Moves played or taken back
+    uint64_t squaresRecomputed = 0; // Attacks of a piece computed again, summed over all updates
+};
+
+// A piece as stored on the board, in one byte: the piece type (Pieces) in the low three bits and the color
+// in bit 3. The default value is an empty square, which converts to false.
 class Piece {
-protected:
-    Colors pieceColor;
-    Pieces pieceName;
-    Position position;
-    bool hasMoved; // To know if the Pawn made his first move. 
-    string symbol;
+private:
+    uint8_t code;
 
 public:
-    Piece(Colors color, Pieces name, Position pos);
-    Piece(Colors color, Pieces name);
-    virtual ~Piece() {}
-    bool getHasMoved();
-    void setHasMoved(bool moved);
-    Colors getColor() const; 
-    virtual string getName() const = 0;
-    virtual bool isValidMove(Position start, Position end, const Board& board) const = 0;
-    Position getPosition() const;
-    void setPosition(const Position& newPosition);
-    virtual Pieces getType() const = 0;
-    virtual char getSymbol() const = 0;
+    Piece() : code(0) {}
+    Piece(Colors color, Pieces type) : code(static_cast<uint8_t>(type) | (color == Colors::Black ? 8 : 0)) {}
+    explicit operator bool() const { return code != 0; }
+    bool operator==(const Piece& other) const { return code == other.code; }
+    bool operator!=(const Piece& other) const { return code != other.code; }
+    Pieces getType() const { return static_cast<Pieces>(code & 7); }
+    Colors getColor() const { return (code == 0) ? Colors::Empty : (code & 8) ? Colors::Black : Colors::White; }
+    string getName() const;
+    char getSymbol() const;
+    bool isValidMove(Position start, Position end, const Board& board) const;
+};
+
+// What makeMove changed that the move itself does not tell, so unmakeMove can restore it
+struct UndoRecord {
+    Move move;
+    Piece capturedPiece;    // Empty if nothing was captured
+    int enPassantSquare;
+    int movesWithoutPawnOrCapture;
+    int castlingRights;
+    uint64_t hashKey;
+    Position whiteKingPosition;
+    Position blackKingPosition;
+    Bitboard movedPieces;
 };
 
+// Plies of key history a snapshot keeps. Only positions since the last pawn move or capture can repeat, and
+// the fifty-move rule ends the game before older ones could.
+const int SnapshotHistory = 100;
+
+// A position with everything the board keeps up to date about it, in one fixed-size block without pointers, so
+// it is copied with memcpy and needs no heap memory. Board::saveSnapshot and Board::restoreSnapshot convert.
+struct BoardSnapshot {
+    Bitboard pieceBitboards[2][7];
+    Bitboard colorBitboards[2];
+    Bitboard occupied;
+    Bitboard movedPieces;
+    Bitboard pieceAttacks[64];
+    Bitboard attackMaps[2];
+    uint64_t hashKey;
+    Piece squares[64];
+    Position whiteKingPosition;
+    Position blackKingPosition;
+    Colors sideToMove;
+    int movesWithoutPawnOrCapture;
+    int fullMoveNumber;
+    int enPassantSquare;
+    int castlingRights;
+    int middlegameScore;
+    int endgameScore;
+    int gamePhase;
+    uint8_t pieceCounts[2][7];
+    uint8_t bishopCounts[2][2];
+    int historyLength;                      // Keys in keyHistory, the most recent last
+    uint64_t keyHistory[SnapshotHistory];   // Keys of the positions before the last moves, for repetition detection
+};
+static_assert(is_trivially_copyable_v<BoardSnapshot>, "Snapshots are copied with memcpy");
+
+// The board holds no pointers, so copying it is a flat copy plus the move history. Parallel search threads
+// each search their own copy. A BoardSnapshot is the same position without the undo stack, for copies that
+// need no heap memory.
 class Board {
 private:
-    Piece*** board;
+    // Bitboard position: one set per color and piece type (indexed by Pieces), per color, and all pieces.
+    Bitboard pieceBitboards[2][7];
+    Bitboard colorBitboards[2];
+    Bitboard occupied;
+    Piece squares[64];      // The piece on each square, indexed by square
+    Bitboard movedPieces;   // Squares holding a piece that has moved since the start of the game
+    Bitboard pieceAttacks[64]; // Squares attacked by the piece on each square, 0 for an empty square
+    Bitboard attackMaps[2];    // Squares attacked by each color, the union of its pieces' attacks
+    AttackMapStats attackStats;
     Position whiteKingPosition;
     Position blackKingPosition;
-    std::map<std::string, int> boardHistory;
-    int movesWithoutPawnOrCapture = 0;
+    Colors sideToMove = Colors::White;
+    int movesWithoutPawnOrCapture = 0; // Plies since the last pawn move or capture (the FEN halfmove clock)
+    int fullMoveNumber = 1;            // Starts at 1 and grows after each Black move, as in FEN
+    int enPassantSquare = -1; // Square a pawn skipped with a double move on the last move, if it can be captured there. -1 if none
+    int castlingRights = AllCastlingRights;
+    uint64_t hashKey = 0;      // Zobrist key of the position, updated with every change to the board
+    int middlegameScore = 0;   // Piece-square sums of the evaluation from White's point of view, and the game
+    int endgameScore = 0;      // phase, updated with every change to the board like the key
+    int gamePhase = 0;
+    uint8_t pieceCounts[2][7];   // Pieces of each color and type (indexed by Pieces), updated with every change
+    uint8_t bishopCounts[2][2];  // Bishops of each color on dark (0) and light (1) squares
+    vector<UndoRecord> undoStack;
+    vector<uint64_t> keyHistory; // Keys of the positions before each move played, for repetition detection
 
 public:
     Board();
-    ~Board();
-    Piece* getPieceAt(Position pos) const;
+    explicit Board(const BoardSnapshot& snapshot);
+    bool fromFEN(string_view fen);
+    size_t toFEN(char* buffer) const;
+    string toFEN() const;
+    Piece getPieceAt(Position pos) const;
+    bool hasPieceMoved(Position pos) const;
     void printBoard() const;
     bool isOpponentAt(Position pos, Colors color) const;
     bool isInCheck(Colors kingColor) const;
-    bool isCheckMate(Colors kingColor);
-    bool movePiece(const Position& start, const Position& end, bool isSimulation = false);
-    bool isDraw(Colors currentPlayer) const;
-    void placePieceAt(const Position& position, Piece* piece);
+    bool isCheckMate(Colors kingColor, int legalMoveCount = -1) const;
+    bool movePiece(const Position& start, const Position& end, Pieces promotion = Pieces::Queen);
+    void makeMove(const Move& move);
+    void unmakeMove();
+    void saveSnapshot(BoardSnapshot& snapshot) const;
+    void restoreSnapshot(const BoardSnapshot& snapshot);
+    bool isDraw(Colors currentPlayer, int legalMoveCount = -1) const;
+    bool isThreefoldRepetition() const;
+    bool isInsufficientMaterial() const;
+    GameEnd getGameEnd(int legalMoveCount = -1) const;
+    int countRepetitions(int limit) const;
+    uint64_t getHashKey() const;
+    Colors getSideToMove() const;
+    Bitboard getOccupied() const;
+    Bitboard getPiecesOf(Colors color) const;
+    Bitboard getPieces(Colors color, Pieces type) const;
+    int getHalfmoveClock() const;
+    int getFullMoveNumber() const;
+    int getCastlingRights() const;
+    int getEnPassantSquare() const;
+    int getEvaluation() const;
+    Bitboard getAttackMap(Colors color) const;
+    AttackMapStats getAttackMapStats() const;
+    void placePieceAt(const Position& position, Piece piece);
     bool isUnderAttack(Colors opponentColor, Position position) const;
     bool canCastle(const Position& kingStart, const Position& kingEnd) const;
+    bool isEnPassantAt(Position pos) const;
+    MoveList generateLegalMoves(Colors color) const;
+
+private:
+    void clearBoard();
+    Move createMove(const Position& start, const Position& end, Pieces promotion) const;
+    void setPiece(int square, Piece piece);
+    Piece clearSquare(int square);
+    Bitboard attackersTo(int square, Colors attackerColor, Bitboard occupancy) const;
+    Bitboard attacksFrom(int square) const;
+    void updateAttackMaps(Bitboard changedSquares);
+    void generatePseudoLegalMoves(Colors color, MoveList& moves) const;
+    Bitboard pinnedPieces(Colors color, int kingSquare) const;
+    bool leavesKingInCheck(const Move& move, Colors color) const;
 };
 
 // Include chess piece headers here
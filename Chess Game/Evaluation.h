@@ -0,0 +1,39 @@
+/*
+ * File: Evaluation.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the piece-square tables of the static evaluation.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class Board;
+
+// The evaluation is the sum of one value per piece on its square (its material plus a bonus for the square),
+// counted once for the middlegame and once for the endgame, and blended by how much material is left. The
+// board keeps both sums and the phase up to date as pieces are placed and removed, so evaluating a position
+// costs a few multiplications.
+struct PieceSquareTables {
+    int middlegame[2][7][64]; // [color index][piece type][square], positive for White and negative for Black
+    int endgame[2][7][64];
+    int phase[7];             // Weight of each piece type in the game phase
+};
+
+extern const PieceSquareTables PieceSquare;
+
+// Phase of the starting position; lower phases count more towards the endgame
+const int MaxGamePhase = 24;
+
+// Blend the middlegame and endgame scores by the game phase. Promotions can take the phase over the maximum.
+inline int taperedScore(int middlegame, int endgame, int phase) {
+    if (phase > MaxGamePhase) {
+        phase = MaxGamePhase;
+    }
+    return (middlegame * phase + endgame * (MaxGamePhase - phase)) / MaxGamePhase;
+}
+
+// The same evaluation as Board::getEvaluation, summed over the pieces of the board from scratch. Used to check
+// and measure the incremental one.
+int evaluateFromScratch(const Board& board);
@@ -0,0 +1,316 @@
+/*
+ * File: FEN.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of loading and writing Board positions in Forsyth-Edwards Notation.
+ */
+
+#include "Classes.h"
+
+namespace {
+    // Piece letters as used in FEN, indexed by Pieces
+    const char WhiteLetters[] = " PNBRQK";
+    const char BlackLetters[] = " pnbrqk";
+
+    Piece pieceFromLetter(char letter) {
+        switch (letter) {
+        case 'P': return Piece(Colors::White, Pieces::Pawn);
+        case 'N': return Piece(Colors::White, Pieces::Knight);
+        case 'B': return Piece(Colors::White, Pieces::Bishop);
+        case 'R': return Piece(Colors::White, Pieces::Rook);
+        case 'Q': return Piece(Colors::White, Pieces::Queen);
+        case 'K': return Piece(Colors::White, Pieces::King);
+        case 'p': return Piece(Colors::Black, Pieces::Pawn);
+        case 'n': return Piece(Colors::Black, Pieces::Knight);
+        case 'b': return Piece(Colors::Black, Pieces::Bishop);
+        case 'r': return Piece(Colors::Black, Pieces::Rook);
+        case 'q': return Piece(Colors::Black, Pieces::Queen);
+        case 'k': return Piece(Colors::Black, Pieces::King);
+        default: return Piece();
+        }
+    }
+
+    // Take the next space separated field off the front of the text. Empty when there is none left.
+    string_view nextField(string_view& text) {
+        size_t start = text.find_first_not_of(' ');
+        if (start == string_view::npos) {
+            text = string_view();
+            return text;
+        }
+        size_t end = text.find(' ', start);
+        if (end == string_view::npos) {
+            end = text.size();
+        }
+        string_view field = text.substr(start, end - start);
+        text.remove_prefix(end);
+        return field;
+    }
+
+    // Parse a non-negative number. Returns false unless the whole field is digits.
+    bool parseNumber(string_view field, int& number) {
+        if (field.empty() || field.size() > 6) {
+            return false;
+        }
+        number = 0;
+        for (char digit : field) {
+            if (digit < '0' || digit > '9') {
+                return false;
+            }
+            number = number * 10 + (digit - '0');
+        }
+        return true;
+    }
+
+    // Check if the king of kingColor is attacked by a piece of the other color in the placement
+    bool isKingAttacked(const Piece (&placement)[64], Colors kingColor) {
+        Bitboard occupancy = 0;
+        int kingSquare = -1;
+        for (int square = 0; square < 64; square++) {
+            if (placement[square]) {
+                occupancy |= squareBit(square);
+                if (placement[square] == Piece(kingColor, Pieces::King)) {
+                    kingSquare = square;
+                }
+            }
+        }
+        for (int square = 0; square < 64; square++) {
+            Piece piece = placement[square];
+            if (!piece || piece.getColor() == kingColor) {
+                continue;
+            }
+            Bitboard attacks = 0;
+            switch (piece.getType()) {
+            case Pieces::Pawn: attacks = PawnAttacks[colorIndex(piece.getColor())][square]; break;
+            case Pieces::Knight: attacks = KnightAttacks[square]; break;
+            case Pieces::Bishop: attacks = bishopAttacks(square, occupancy); break;
+            case Pieces::Rook: attacks = rookAttacks(square, occupancy); break;
+            case Pieces::Queen: attacks = queenAttacks(square, occupancy); break;
+            default: attacks = KingAttacks[square]; break;
+            }
+            if (attacks & squareBit(kingSquare)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Write a non-negative number and return the position after it
+    char* writeNumber(char* out, int number) {
+        char digits[12];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + number % 10);
+            number /= 10;
+        } while (number > 0);
+        while (count > 0) {
+            *out++ = digits[--count];
+        }
+        return out;
+    }
+}
+
+// Load the position described by the FEN text, replacing everything on the board including the move history.
+// The halfmove clock and fullmove number may be left out, as in EPD test suites. Returns false, leaving the
+// board unchanged, if the text is not a valid FEN or the position cannot arise in a game: a color without
+// exactly one king, a pawn on the first or last row, or the side not to move in check.
+bool Board::fromFEN(string_view fen) {
+    Piece placement[64];
+    int kingCount[2] = { 0, 0 };
+
+    // Piece placement, from row 7 (rank 8) down to row 0, each row from column a to h
+    string_view field = nextField(fen);
+    int row = 7, col = 0;
+    for (char c : field) {
+        if (c == '/') {
+            if (col != 8 || row == 0) {
+                return false;
+            }
+            row--;
+            col = 0;
+        }
+        else if (c >= '1' && c <= '8') {
+            for (int empty = c - '0'; empty > 0; empty--) {
+                if (col >= 8) {
+                    return false;
+                }
+                placement[squareIndex(row, col++)] = Piece();
+            }
+        }
+        else {
+            Piece piece = pieceFromLetter(c);
+            // Pawns never stand on the first or last row: they start on the second and promote on the last
+            if (!piece || col >= 8 || (piece.getType() == Pieces::Pawn && (row == 0 || row == 7))) {
+                return false;
+            }
+            if (piece.getType() == Pieces::King) {
+                kingCount[colorIndex(piece.getColor())]++;
+            }
+            placement[squareIndex(row, col++)] = piece;
+        }
+    }
+    if (row != 0 || col != 8 || kingCount[0] != 1 || kingCount[1] != 1) {
+        return false;
+    }
+
+    // Side to move
+    field = nextField(fen);
+    if (field != "w" && field != "b") {
+        return false;
+    }
+    Colors side = (field == "w") ? Colors::White : Colors::Black;
+
+    // The side that just moved cannot have left its king in check
+    if (isKingAttacked(placement, oppositeColor(side))) {
+        return false;
+    }
+
+    // Castling rights, kept only where the king and rook still stand on their starting squares
+    field = nextField(fen);
+    int rights = 0;
+    if (field != "-") {
+        for (char c : field) {
+            switch (c) {
+            case 'K': rights |= WhiteKingside; break;
+            case 'Q': rights |= WhiteQueenside; break;
+            case 'k': rights |= BlackKingside; break;
+            case 'q': rights |= BlackQueenside; break;
+            default: return false;
+            }
+        }
+    }
+    if (placement[4] != Piece(Colors::White, Pieces::King)) {
+        rights &= ~(WhiteKingside | WhiteQueenside);
+    }
+    if (placement[60] != Piece(Colors::Black, Pieces::King)) {
+        rights &= ~(BlackKingside | BlackQueenside);
+    }
+    if (placement[7] != Piece(Colors::White, Pieces::Rook)) rights &= ~WhiteKingside;
+    if (placement[0] != Piece(Colors::White, Pieces::Rook)) rights &= ~WhiteQueenside;
+    if (placement[63] != Piece(Colors::Black, Pieces::Rook)) rights &= ~BlackKingside;
+    if (placement[56] != Piece(Colors::Black, Pieces::Rook)) rights &= ~BlackQueenside;
+
+    // En passant target square: the square behind a pawn of the other side that just moved two squares
+    field = nextField(fen);
+    int enPassant = -1;
+    if (field != "-") {
+        if (field.size() != 2 || field[0] < 'a' || field[0] > 'h' || field[1] != ((side == Colors::White) ? '6' : '3')) {
+            return false;
+        }
+        enPassant = squareIndex(field[1] - '1', field[0] - 'a');
+    }
+
+    // Halfmove clock and fullmove number, optional
+    int halfmoveClock = 0, fullMoves = 1;
+    field = nextField(fen);
+    if (!field.empty()) {
+        if (!parseNumber(field, halfmoveClock)) {
+            return false;
+        }
+        field = nextField(fen);
+        if (!field.empty() && (!parseNumber(field, fullMoves) || fullMoves < 1)) {
+            return false;
+        }
+    }
+
+    // The text is valid: replace the position
+    clearBoard();
+    for (int square = 0; square < 64; square++) {
+        Piece piece = placement[square];
+        if (!piece) {
+            continue;
+        }
+        setPiece(square, piece);
+        if (piece.getType() == Pieces::King) {
+            (piece.getColor() == Colors::White ? whiteKingPosition : blackKingPosition) = squarePosition(square);
+        }
+        // FEN does not say which pieces have moved. Only a pawn on its starting row can still be unmoved; for
+        // kings and rooks the castling rights carry that information.
+        int pawnStartRow = (piece.getColor() == Colors::White) ? 1 : 6;
+        if (piece.getType() != Pieces::Pawn || square / 8 != pawnStartRow) {
+            movedPieces |= squareBit(square);
+        }
+    }
+
+    sideToMove = side;
+    if (side == Colors::Black) {
+        hashKey ^= Zobrist.blackToMove;
+    }
+    castlingRights = rights;
+    hashKey ^= Zobrist.castling[castlingRights];
+
+    // Like makeMove, keep the en passant square only if a pawn of the side to move can capture there
+    if (enPassant >= 0 && (PawnAttacks[1 - colorIndex(side)][enPassant] & pieceBitboards[colorIndex(side)][static_cast<int>(Pieces::Pawn)])) {
+        enPassantSquare = enPassant;
+        hashKey ^= Zobrist.enPassantFile[enPassant % 8];
+    }
+    movesWithoutPawnOrCapture = halfmoveClock;
+    fullMoveNumber = fullMoves;
+
+    // Empty squares already have no attacks after clearBoard
+    updateAttackMaps(occupied);
+    attackStats = AttackMapStats();
+    return true;
+}
+
+// Write the position as FEN into the buffer, which must hold FENBufferSize characters. The text is
+// null-terminated; the return value is its length.
+size_t Board::toFEN(char* buffer) const {
+    char* out = buffer;
+
+    for (int row = 7; row >= 0; row--) {
+        int empty = 0;
+        for (int col = 0; col < 8; col++) {
+            Piece piece = squares[squareIndex(row, col)];
+            if (!piece) {
+                empty++;
+                continue;
+            }
+            if (empty > 0) {
+                *out++ = static_cast<char>('0' + empty);
+                empty = 0;
+            }
+            int type = static_cast<int>(piece.getType());
+            *out++ = (piece.getColor() == Colors::White) ? WhiteLetters[type] : BlackLetters[type];
+        }
+        if (empty > 0) {
+            *out++ = static_cast<char>('0' + empty);
+        }
+        if (row > 0) {
+            *out++ = '/';
+        }
+    }
+
+    *out++ = ' ';
+    *out++ = (sideToMove == Colors::White) ? 'w' : 'b';
+
+    *out++ = ' ';
+    if (castlingRights == 0) {
+        *out++ = '-';
+    }
+    if (castlingRights & WhiteKingside) *out++ = 'K';
+    if (castlingRights & WhiteQueenside) *out++ = 'Q';
+    if (castlingRights & BlackKingside) *out++ = 'k';
+    if (castlingRights & BlackQueenside) *out++ = 'q';
+
+    *out++ = ' ';
+    if (enPassantSquare >= 0) {
+        *out++ = static_cast<char>('a' + enPassantSquare % 8);
+        *out++ = static_cast<char>('1' + enPassantSquare / 8);
+    }
+    else {
+        *out++ = '-';
+    }
+
+    *out++ = ' ';
+    out = writeNumber(out, movesWithoutPawnOrCapture);
+    *out++ = ' ';
+    out = writeNumber(out, fullMoveNumber);
+    *out = '\0';
+    return static_cast<size_t>(out - buffer);
+}
+
+string Board::toFEN() const {
+    char buffer[FENBufferSize];
+    size_t length = toFEN(buffer);
+    return string(buffer, length);
+}
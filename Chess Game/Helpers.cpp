@@ -6,35 +6,44 @@
  */
 
 #include "Helpers.h"
-#include <sstream>
 #include <algorithm> // Required for transform
 #include <cctype>    // Required for tolower
 
-Piece* parseMoveAndGetPiece(const string& moveInput, Colors currentPlayer, const Board& board, Position& startPosition, Position& endPosition) {
+Piece parseMoveAndGetPiece(const string& moveInput, Colors currentPlayer, const Board& board, Position& startPosition, Position& endPosition) {
     // Parse the move input and identify the piece
-    istringstream iss(moveInput);
-    string startStr, to, endStr;
-
-    if (iss >> startStr >> to >> endStr) {
-        // Parse the start and end positions
-        if (parsePosition(startStr, startPosition) && parsePosition(endStr, endPosition)) {
-            // Get the piece at the start position
-            Piece* piece = board.getPieceAt(startPosition);
-
-            // if this Piece is mine, so return it
-            if (piece && piece->getColor() == currentPlayer) {
-                return piece;
-            }
+    if (parseMoveInput(moveInput, startPosition, endPosition)) {
+        // Get the piece at the start position
+        Piece piece = board.getPieceAt(startPosition);
+
+        // if this Piece is mine, so return it
+        if (piece && piece.getColor() == currentPlayer) {
+            return piece;
+        }
+    }
+    return Piece(); // Invalid move or piece
+}
+
+// Parse a move written "<start> to <end>", e.g. "e2 to e4", without allocating. Anything after the end square
+// is ignored. Returns false if the text does not start with a move.
+bool parseMoveInput(string_view moveInput, Position& startPosition, Position& endPosition) {
+    string_view words[3];
+    size_t position = 0;
+    for (string_view& word : words) {
+        size_t start = moveInput.find_first_not_of(" \t\r", position);
+        if (start == string_view::npos) {
+            return false;
         }
+        position = moveInput.find_first_of(" \t\r", start);
+        word = moveInput.substr(start, (position == string_view::npos) ? string_view::npos : position - start);
     }
-    return nullptr; // Invalid move or piece
+    return parsePosition(words[0], startPosition) && parsePosition(words[2], endPosition);
 }
 
 
 
 
 // This function gets a position as a string and returns the position for the board. returns true if succeed, else false.
-bool parsePosition(const string& positionStr, Position& position) {
+bool parsePosition(string_view positionStr, Position& position) {
     if (positionStr.length() != 2) {
         return false; // Invalid position format
     }
@@ -67,3 +76,59 @@ bool parsePosition(const string& positionStr, Position& position) {
 
 
 
+// Name a square in standard coordinates, where rank 1 is row 0 (the white side). Note that the interactive
+// game labels rows the other way round (see parsePosition).
+string squareToString(int square) {
+    string name = "a1";
+    name[0] = static_cast<char>('a' + square % 8);
+    name[1] = static_cast<char>('1' + square / 8);
+    return name;
+}
+
+// Write a move in coordinate notation, e.g. "e2e4" or "e7e8q" for a promotion
+string moveToString(const Move& move) {
+    string text = squareToString(move.from) + squareToString(move.to);
+    switch (move.promotion) {
+    case Pieces::Queen: text += 'q'; break;
+    case Pieces::Rook: text += 'r'; break;
+    case Pieces::Bishop: text += 'b'; break;
+    case Pieces::Knight: text += 'n'; break;
+    default: break;
+    }
+    return text;
+}
+
+// Find the move written in coordinate notation, as moveToString writes it, among the moves, without
+// allocating. A promotion without its letter becomes a queen. Returns nullptr if the text is not a move or
+// the move is not in the list.
+const Move* findCoordinateMove(string_view text, const MoveList& moves) {
+    size_t start = text.find_first_not_of(" \t\r");
+    size_t end = text.find_last_not_of(" \t\r");
+    if (start == string_view::npos || end - start + 1 < 4 || end - start + 1 > 5) {
+        return nullptr;
+    }
+    text = text.substr(start, end - start + 1);
+    for (int i : { 0, 2 }) {
+        if (text[i] < 'a' || text[i] > 'h' || text[i + 1] < '1' || text[i + 1] > '8') {
+            return nullptr;
+        }
+    }
+    int from = squareIndex(text[1] - '1', text[0] - 'a');
+    int to = squareIndex(text[3] - '1', text[2] - 'a');
+    Pieces promotion = Pieces::Queen;
+    if (text.size() == 5) {
+        switch (text[4]) {
+        case 'q': promotion = Pieces::Queen; break;
+        case 'r': promotion = Pieces::Rook; break;
+        case 'b': promotion = Pieces::Bishop; break;
+        case 'n': promotion = Pieces::Knight; break;
+        default: return nullptr;
+        }
+    }
+    for (const Move& move : moves) {
+        if (move.from == from && move.to == to && (move.promotion == Pieces::None ? text.size() == 4 : move.promotion == promotion)) {
+            return &move;
+        }
+    }
+    return nullptr;
+}
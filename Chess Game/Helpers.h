@@ -9,5 +9,9 @@
 #include <string>
 #include "Classes.h" // Include the necessary headers
 
-Piece* parseMoveAndGetPiece(const string& moveInput, Colors currentPlayer, const Board& board, Position& startPosition, Position& endPosition);
-bool parsePosition(const string& positionStr, Position& position);
+Piece parseMoveAndGetPiece(const string& moveInput, Colors currentPlayer, const Board& board, Position& startPosition, Position& endPosition);
+bool parseMoveInput(string_view moveInput, Position& startPosition, Position& endPosition);
+bool parsePosition(string_view positionStr, Position& position);
+string squareToString(int square);
+string moveToString(const Move& move);
+const Move* findCoordinateMove(string_view text, const MoveList& moves);
@@ -1,25 +1,151 @@
 #include "Classes.h"
 #include "ChessPieces.h"
 #include "Helpers.h"
+#include "OpeningBook.h"
+#include "Renderer.h"
+#include <fstream>
 #include <iostream>
 #include <sstream> // Include this header for stringstream
 using namespace std;
 
-int main() {
+// State of the game after a move, as written in the headless status lines
+const char* statusName(GameEnd end, bool inCheck) {
+    switch (end) {
+    case GameEnd::Checkmate: return "checkmate";
+    case GameEnd::Stalemate: return "stalemate";
+    case GameEnd::FiftyMoveRule: return "draw 50-move";
+    case GameEnd::ThreefoldRepetition: return "draw repetition";
+    case GameEnd::InsufficientMaterial: return "draw insufficient-material";
+    default: return inCheck ? "check" : "ok";
+    }
+}
+
+// Headless mode: read one move per line in coordinate notation ("e2e4", "e7e8q"; standard ranks, unlike the
+// interactive game) and write one status line per move, without drawing the board or prompting:
+//   <line> legal <ok|check|checkmate|stalemate|draw <reason>>
+//   <line> illegal
+// Once the game is over every further move is illegal. A line reading "new" starts a new game and is answered
+// with "<line> new". Returns the number of illegal moves.
+int runHeadless(istream& input) {
+    Board chessBoard;
+    MoveList legalMoves = chessBoard.generateLegalMoves(chessBoard.getSideToMove());
+    bool gameOver = false;
+    int illegalMoves = 0;
+    string output;
+    string moveInput;
+    for (long long line = 1; getline(input, moveInput); line++) {
+        output += to_string(line);
+        if (moveInput == "new" || moveInput == "new\r") {
+            chessBoard.fromFEN(StartFEN);
+            legalMoves = chessBoard.generateLegalMoves(chessBoard.getSideToMove());
+            gameOver = false;
+            output += " new\n";
+            continue;
+        }
+
+        // The move has to be one of the current player's legal moves. They are generated once per position,
+        // and also tell whether the game is over.
+        const Move* move = gameOver ? nullptr : findCoordinateMove(moveInput, legalMoves);
+
+        if (move) {
+            chessBoard.makeMove(*move);
+            legalMoves = chessBoard.generateLegalMoves(chessBoard.getSideToMove());
+            GameEnd end = chessBoard.getGameEnd(legalMoves.count);
+            gameOver = (end != GameEnd::None);
+            output += " legal ";
+            output += statusName(end, chessBoard.isInCheck(chessBoard.getSideToMove()));
+        }
+        else {
+            illegalMoves++;
+            output += " illegal";
+        }
+        output += '\n';
+
+        // Write in large blocks rather than line by line
+        if (output.size() >= 1 << 16) {
+            cout << output;
+            output.clear();
+        }
+    }
+    cout << output << flush;
+    return illegalMoves;
+}
+
+// A square as the interactive game names it: rows are numbered from the top of the printed board, so White's
+// back rank is row 8
+string gameSquareName(int square) {
+    string name(1, static_cast<char>('a' + square % 8));
+    name += static_cast<char>('8' - square / 8);
+    return name;
+}
+
+// The book moves of the position, most played first, in the notation the player types
+void printBookMoves(const OpeningBook& book, const Board& board) {
+    const int shownMoves = 5;
+    BookMove moves[shownMoves];
+    int found = book.findMoves(board, moves, shownMoves);
+    if (found == 0) {
+        return;
+    }
+    cout << "Book moves:";
+    for (int i = 0; i < found; i++) {
+        cout << (i > 0 ? ", " : " ") << gameSquareName(moves[i].move.from) << " to " << gameSquareName(moves[i].move.to);
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
+    // Headless mode, reading the moves from the given file or from the standard input
+    if (argc >= 2 && string(argv[1]) == "--headless") {
+        ios::sync_with_stdio(false);
+        if (argc >= 3) {
+            ifstream file(argv[2]);
+            if (!file) {
+                cerr << "Cannot open " << argv[2] << endl;
+                return 2;
+            }
+            return runHeadless(file) > 0 ? 1 : 0;
+        }
+        return runHeadless(cin) > 0 ? 1 : 0;
+    }
+
+    // ANSI mode keeps the board in place at the top of the terminal and redraws only the squares that change.
+    // With an opening book, the moves it knows are shown before each move.
+    bool ansi = false;
+    OpeningBook book;
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "--ansi") {
+            ansi = true;
+        }
+        else if (string(argv[i]) == "--book" && i + 1 < argc) {
+            if (!book.open(argv[++i])) {
+                cerr << "Cannot open the opening book " << argv[i] << endl;
+                return 2;
+            }
+        }
+    }
+    BoardRenderer renderer(ansi);
+
     // Initialize the chess board
     Board chessBoard;
     // Print the initial setup of the board
-    cout << "Initial Chess Board Setup: " << std::endl;
-    chessBoard.printBoard();
+    if (!ansi) {
+        cout << "Initial Chess Board Setup: " << std::endl;
+    }
+    renderer.render(chessBoard, cout);
     cout << "\n";
 
     // Game loop variables
     bool gameOver = false;
     Colors currentPlayer = Colors::White;
+    // The current player's legal moves, generated once per turn: they check the move entered and, generated
+    // right after the previous move, tell whether that move ended the game
+    MoveList legalMoves = chessBoard.generateLegalMoves(currentPlayer);
 
     while (!gameOver) {
         // Print the current player's turn
         cout << (currentPlayer == Colors::White ? "White's Turn" : "Black's Turn") << endl;
+        printBookMoves(book, chessBoard);
 
         // Prompt the current player for a move input
         cout << "Enter your move (e.g., 'e2 to e4'): ";
@@ -28,56 +154,44 @@ int main() {
 
        // Parse the move input and identify the piece
         Position startPosition, endPosition;
-        Piece* pieceToMove = parseMoveAndGetPiece(moveInput, currentPlayer, chessBoard, startPosition, endPosition);
+        Piece pieceToMove = parseMoveAndGetPiece(moveInput, currentPlayer, chessBoard, startPosition, endPosition);
 
         if (!pieceToMove) {
             cout << "Invalid move or piece. Try again." << endl;
             continue;
         }
         if (pieceToMove) {
-            // Check if the move is valid for the identified piece
-            if (!pieceToMove->isValidMove(startPosition, endPosition, chessBoard)) {
-                if (typeid(*pieceToMove) == typeid(Bishop)) {
+            // The move has to be one of the current player's legal moves. A pawn reaching the last row becomes a
+            // queen, the first promotion generated.
+            const Move* move = legalMoves.find(startPosition, endPosition);
+            if (!move) {
+                // Explain why: either the piece cannot move like that, or the move leaves the own king in check
+                if (pieceToMove.isValidMove(startPosition, endPosition, chessBoard)) {
+                    cout << "Invalid move. Your King is in check. Try another move." << endl;
+                }
+                else if (pieceToMove.getType() == Pieces::Bishop) {
                     cout << "Bishops can only move diagonally. " << endl;
                 }
-                else if (typeid(*pieceToMove) == typeid(Knight)) {
+                else if (pieceToMove.getType() == Pieces::Knight) {
                     cout << "Knights move in an L-shape: two squares in one direction and one square perpendicular, or vice versa." << endl;
                 }
-                else if (typeid(*pieceToMove) == typeid(Rook)) {
+                else if (pieceToMove.getType() == Pieces::Rook) {
                     cout << "Rooks can only move in straight lines either horizontally or vertically." << endl;
                 }
-                else if (typeid(*pieceToMove) == typeid(Queen)) {
+                else if (pieceToMove.getType() == Pieces::Queen) {
                     cout << "Queens can move in any straight line: horizontally, vertically, or diagonally." << endl;
                 }
-                else if (typeid(*pieceToMove) == typeid(King)) {
+                else if (pieceToMove.getType() == Pieces::King) {
                     cout << "Kings can move one square in any direction: horizontally, vertically, or diagonally." << endl;
                 }
-                else if (typeid(*pieceToMove) == typeid(Pawn)) {
+                else if (pieceToMove.getType() == Pieces::Pawn) {
                     cout << "Pawns move forward one square but capture diagonally. They have a unique double move from their starting position." << endl;
                 }
                 continue;
             }
 
-            // Store original pieces before making the move
-            Piece* originalPieceAtStart = chessBoard.getPieceAt(startPosition);
-            Piece* originalPieceAtEnd = chessBoard.getPieceAt(endPosition);
-
-            // Apply the valid move to the chessboard
-            chessBoard.movePiece(startPosition, endPosition);
-           
-            // Check if move puts own king in check
-            if (chessBoard.isInCheck(currentPlayer)) {
-                cout << "Invalid move. Your King is in check. Try another move." << endl;
-                // Cancel the move if this move make my own king in check. Restore the board to its original state
-                chessBoard.movePiece(endPosition, startPosition);
-                if (originalPieceAtEnd) {
-                    // Place back any captured piece. Note that this assumes the 'board' member of chessBoard is public.
-                    // If it's private, you'd need to either make it public, use a friend function, or add a helper method in the Board class.
-                    chessBoard.placePieceAt(endPosition, originalPieceAtEnd);
-                    originalPieceAtEnd->setPosition(endPosition); // Update its position                 
-                }
-                continue;
-            }
+            // Apply the legal move to the chessboard. It is already validated, so it is played as headless mode does.
+            chessBoard.makeMove(*move);
 
             // Check if move puts opponent's king in check
             Colors opponentColor = (currentPlayer == Colors::White) ? Colors::Black : Colors::White;
@@ -86,19 +200,23 @@ int main() {
             }
 
 
-            // Check for checkmate or draw conditions
-            if (chessBoard.isCheckMate(opponentColor)) {
-                cout << (currentPlayer == Colors::White ? "Black" : "White") << " wins by checkmate!" << endl;
+            // Check for checkmate or draw conditions for the player who moves next, from the legal moves of
+            // the next turn
+            legalMoves = chessBoard.generateLegalMoves(opponentColor);
+            if (chessBoard.isCheckMate(opponentColor, legalMoves.count)) {
+                cout << (currentPlayer == Colors::White ? "White" : "Black") << " wins by checkmate!" << endl;
                 gameOver = true;
             }
-            else if (chessBoard.isDraw(currentPlayer)) {
+            else if (chessBoard.isDraw(opponentColor, legalMoves.count)) {
                 cout << "The game is a draw." << endl;
                 gameOver = true;
             }
 
             // Print the updated board
-            cout << "Updated Chess Board: " << endl;
-            chessBoard.printBoard();
+            if (!ansi) {
+                cout << "Updated Chess Board: " << endl;
+            }
+            renderer.render(chessBoard, cout);
 
             // Switch to the other player for the next turn
             currentPlayer = (currentPlayer == Colors::White) ? Colors::Black : Colors::White;
@@ -107,6 +225,7 @@ int main() {
         }
     }
 
+    renderer.finish(cout);
     return 0;
 }
 
@@ -0,0 +1,110 @@
+/*
+ * File: MappedFile.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the read-only file mapping, with the Windows and the POSIX calls.
+ */
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const char* path) {
+    close();
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        file = nullptr;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) {
+        return true; // An empty file cannot be mapped, and has no text anyway
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping) {
+        data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    }
+    if (!data) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::close() {
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping) {
+        CloseHandle(mapping);
+    }
+    if (file) {
+        CloseHandle(file);
+    }
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+    file = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const char* path) {
+    close();
+    descriptor = ::open(path, O_RDONLY);
+    if (descriptor < 0) {
+        return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0) {
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(status.st_size);
+    if (size == 0) {
+        return true; // An empty file cannot be mapped, and has no text anyway
+    }
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (view == MAP_FAILED) {
+        close();
+        return false;
+    }
+    // The file is read from start to end
+    madvise(view, size, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(view);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data) {
+        munmap(const_cast<char*>(data), size);
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+    data = nullptr;
+    size = 0;
+    descriptor = -1;
+}
+
+#endif
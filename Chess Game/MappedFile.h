@@ -0,0 +1,37 @@
+/*
+ * File: MappedFile.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing a read-only memory mapping of a whole file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// A file mapped into memory for reading. The text view stays valid as long as the object lives; the
+// operating system pages the file in as it is read, so even very large files cost no copying.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Map the file, replacing any file mapped before. Returns false if it cannot be opened or mapped.
+    bool open(const char* path);
+    void close();
+
+    std::string_view text() const { return std::string_view(data, size); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    void* file = nullptr;
+    void* mapping = nullptr;
+#else
+    int descriptor = -1;
+#endif
+};
@@ -0,0 +1,185 @@
+/*
+ * File: MoveGenerator.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the legal move generator of the Board class.
+ */
+
+#include "Classes.h"
+#include "ChessPieces.h"
+#include "Trace.h"
+
+// Find the move from start to end, nullptr if it is not in the list
+const Move* MoveList::find(const Position& start, const Position& end) const {
+    int from = squareIndex(start);
+    int to = squareIndex(end);
+    for (const Move& move : *this) {
+        if (move.from == from && move.to == to) {
+            return &move;
+        }
+    }
+    return nullptr;
+}
+
+// Generate every legal move of the given color
+MoveList Board::generateLegalMoves(Colors color) const {
+    MoveList moves;
+    generatePseudoLegalMoves(color, moves);
+
+    // The pieces checking the king and the own pieces pinned to it, found once for the position. A move of any
+    // other piece is legal unless the king is in check, and then only if it captures the checking piece or
+    // blocks its line; a pinned piece must also stay on the line of its pin. Only king moves, castling and en
+    // passant captures, which can uncover the king in other ways, are tested by playing them on the occupancy.
+    int kingSquare = squareIndex((color == Colors::White) ? whiteKingPosition : blackKingPosition);
+    Bitboard checkers = attackersTo(kingSquare, oppositeColor(color), occupied);
+    Bitboard pinned = pinnedPieces(color, kingSquare);
+    Bitboard kingBit = squareBit(kingSquare);
+    Bitboard evasions = ~0ULL;
+    if (checkers) {
+        // With two checkers only the king can move
+        evasions = (checkers & (checkers - 1)) ? 0 : checkers | BetweenSquares[kingSquare][lowestSquare(checkers)];
+    }
+
+    int legalCount = 0;
+    for (int i = 0; i < moves.count; i++) {
+        const Move& move = moves.moves[i];
+        bool legal;
+        if ((kingBit & squareBit(move.from)) || (move.flags & EnPassantFlag)) {
+            legal = !leavesKingInCheck(move, color);
+        }
+        else {
+            legal = (evasions & squareBit(move.to))
+                && (!(pinned & squareBit(move.from)) || (LineThrough[kingSquare][move.from] & squareBit(move.to)));
+        }
+        if (legal) {
+            moves.moves[legalCount++] = move;
+        }
+    }
+    moves.count = legalCount;
+    return moves;
+}
+
+// Own pieces that stand alone between the king and an enemy slider attacking along that line, and so cannot
+// leave the line without exposing the king
+Bitboard Board::pinnedPieces(Colors color, int kingSquare) const {
+    const Bitboard* enemies = pieceBitboards[1 - colorIndex(color)];
+    Bitboard enemyQueens = enemies[static_cast<int>(Pieces::Queen)];
+    Bitboard snipers = (rookAttacks(kingSquare, 0) & (enemies[static_cast<int>(Pieces::Rook)] | enemyQueens))
+        | (bishopAttacks(kingSquare, 0) & (enemies[static_cast<int>(Pieces::Bishop)] | enemyQueens));
+    Bitboard pinned = 0;
+    while (snipers) {
+        Bitboard blockers = BetweenSquares[kingSquare][popLowestSquare(snipers)] & occupied;
+        if (blockers && !(blockers & (blockers - 1))) {
+            pinned |= blockers & colorBitboards[colorIndex(color)];
+        }
+    }
+    return pinned;
+}
+
+// Generate the moves allowed by the movement pattern of each piece, without checking the safety of the own king
+void Board::generatePseudoLegalMoves(Colors color, MoveList& moves) const {
+    int us = colorIndex(color);
+    const Bitboard* pieces = pieceBitboards[us];
+    Bitboard enemies = colorBitboards[1 - us];
+    Bitboard targets = ~colorBitboards[us];
+
+    // Pawns: one step forward to an empty square, two from the starting row, diagonal captures and en passant
+    int forward = (color == Colors::White) ? 8 : -8;
+    int startRow = (color == Colors::White) ? 1 : 6;
+    int lastRow = (color == Colors::White) ? 7 : 0;
+    Bitboard enPassantTarget = (enPassantSquare >= 0) ? squareBit(enPassantSquare) : 0;
+    Bitboard pawns = pieces[static_cast<int>(Pieces::Pawn)];
+    while (pawns) {
+        int from = popLowestSquare(pawns);
+        Bitboard destinations = PawnAttacks[us][from] & enemies;
+        int oneStep = from + forward;
+        if (!(occupied & squareBit(oneStep))) {
+            destinations |= squareBit(oneStep);
+            if (from / 8 == startRow && !(occupied & squareBit(oneStep + forward))) {
+                moves.add(from, oneStep + forward, DoublePushFlag);
+            }
+        }
+        while (destinations) {
+            int to = popLowestSquare(destinations);
+            uint8_t flags = (enemies & squareBit(to)) ? CaptureFlag : 0;
+            if (to / 8 == lastRow) {
+                moves.add(from, to, flags, Pieces::Queen);
+                moves.add(from, to, flags, Pieces::Rook);
+                moves.add(from, to, flags, Pieces::Bishop);
+                moves.add(from, to, flags, Pieces::Knight);
+            }
+            else {
+                moves.add(from, to, flags);
+            }
+        }
+        if (PawnAttacks[us][from] & enPassantTarget) {
+            moves.add(from, enPassantSquare, CaptureFlag | EnPassantFlag);
+        }
+    }
+
+    // Knights, bishops, rooks, queens and the king: every attacked square not holding an own piece
+    for (int type = static_cast<int>(Pieces::Knight); type <= static_cast<int>(Pieces::King); type++) {
+        Bitboard piecesOfType = pieces[type];
+        while (piecesOfType) {
+            int from = popLowestSquare(piecesOfType);
+            Bitboard destinations;
+            switch (static_cast<Pieces>(type)) {
+            case Pieces::Knight: destinations = KnightAttacks[from]; break;
+            case Pieces::Bishop: destinations = bishopAttacks(from, occupied); break;
+            case Pieces::Rook: destinations = rookAttacks(from, occupied); break;
+            case Pieces::Queen: destinations = queenAttacks(from, occupied); break;
+            default: destinations = KingAttacks[from]; break;
+            }
+            destinations &= targets;
+            while (destinations) {
+                int to = popLowestSquare(destinations);
+                moves.add(from, to, (enemies & squareBit(to)) ? CaptureFlag : 0);
+            }
+        }
+    }
+
+    // Castling, from the king's starting square towards either rook
+    Position kingStart = (color == Colors::White) ? whiteKingPosition : blackKingPosition;
+    if (kingStart.col == 4 && kingStart.row == ((color == Colors::White) ? 0 : 7)) {
+        if (canCastle(kingStart, { kingStart.row, 6 })) {
+            moves.add(squareIndex(kingStart), squareIndex(kingStart.row, 6), CastlingFlag);
+        }
+        if (canCastle(kingStart, { kingStart.row, 2 })) {
+            moves.add(squareIndex(kingStart), squareIndex(kingStart.row, 2), CastlingFlag);
+        }
+    }
+}
+
+// Check if making the move would leave the king of the given color attacked. The board is not changed:
+// the attack test runs on the occupancy the position would have after the move.
+bool Board::leavesKingInCheck(const Move& move, Colors color) const {
+    TRACE_EVENT(TraceEvent::Simulation, squares[move.from].getType(), move.from, move.to);
+    Bitboard fromBit = squareBit(move.from);
+    Bitboard toBit = squareBit(move.to);
+    Bitboard occupancy = (occupied & ~fromBit) | toBit;
+    Bitboard captured = toBit;
+
+    if (move.flags & EnPassantFlag) {
+        // The captured pawn stands beside the moving pawn, on the row it started from
+        captured = squareBit(squareIndex(move.from / 8, move.to % 8));
+        occupancy &= ~captured;
+    }
+    else if (move.flags & CastlingFlag) {
+        // The rook jumps over the king to the square next to it
+        int row = move.from / 8;
+        bool kingside = move.to % 8 == 6;
+        occupancy &= ~squareBit(squareIndex(row, kingside ? 7 : 0));
+        occupancy |= squareBit(squareIndex(row, kingside ? 5 : 3));
+    }
+
+    int kingSquare;
+    if (pieceBitboards[colorIndex(color)][static_cast<int>(Pieces::King)] & fromBit) {
+        kingSquare = move.to;
+    }
+    else {
+        kingSquare = squareIndex((color == Colors::White) ? whiteKingPosition : blackKingPosition);
+    }
+
+    // A captured piece no longer attacks anything
+    return (attackersTo(kingSquare, oppositeColor(color), occupancy) & ~captured) != 0;
+}
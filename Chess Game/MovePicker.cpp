@@ -0,0 +1,171 @@
+/*
+ * File: MovePicker.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the killer and history heuristics and of the staged move picker.
+ */
+
+#include "MovePicker.h"
+#include <algorithm>
+#include <cstdlib>
+
+void MoveHistory::clear() {
+    for (int ply = 0; ply < MaxPly; ply++) {
+        killers[ply][0] = Move{};
+        killers[ply][1] = Move{};
+    }
+    for (int color = 0; color < 2; color++) {
+        for (int from = 0; from < 64; from++) {
+            for (int to = 0; to < 64; to++) {
+                history[color][from][to] = 0;
+            }
+        }
+    }
+}
+
+void MoveHistory::addCutoff(Colors side, const Move& move, int depth, int ply, const Move* triedQuiets, int triedCount) {
+    if (ply < MaxPly && !sameMove(killers[ply][0], move)) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = move;
+    }
+    // Deeper cutoffs save more work, so they count more
+    int bonus = std::min(depth * depth, MaxHistory / 4);
+    update(side, move, bonus);
+    for (int i = 0; i < triedCount; i++) {
+        update(side, triedQuiets[i], -bonus);
+    }
+}
+
+bool MoveHistory::isKiller(const Move& move, int ply) const {
+    return ply < MaxPly && (sameMove(killers[ply][0], move) || sameMove(killers[ply][1], move));
+}
+
+// Move the score towards the bound by the bonus, less so the closer it already is
+void MoveHistory::update(Colors side, const Move& move, int bonus) {
+    int& score = history[colorIndex(side)][move.from][move.to];
+    score += bonus - score * std::abs(bonus) / MaxHistory;
+}
+
+MovePicker::MovePicker(const Board& board, MoveList& moves, const Move& tableMove, const MoveHistory* history, int ply,
+    bool capturesOnly)
+    : board(board), moves(moves), tableMove(tableMove), history(history), ply(ply), capturesOnly(capturesOnly) {
+    if (capturesOnly) {
+        stage = Stage::ScoreNoisy;
+    }
+}
+
+bool MovePicker::next(Move& move) {
+    while (true) {
+        switch (stage) {
+        case Stage::TableMove:
+            stage = Stage::ScoreNoisy;
+            if (takeMatching(tableMove, move)) {
+                return true;
+            }
+            break;
+
+        case Stage::ScoreNoisy:
+            // Gather the captures at the front of the moves left, and score them
+            stageEnd = current;
+            for (int i = current; i < moves.count; i++) {
+                if (isNoisy(moves.moves[i])) {
+                    std::swap(moves.moves[i], moves.moves[stageEnd]);
+                    scores[stageEnd] = scoreNoisy(moves.moves[stageEnd]);
+                    stageEnd++;
+                }
+            }
+            stage = Stage::Noisy;
+            break;
+
+        case Stage::Noisy:
+            if (pickBest(move)) {
+                return true;
+            }
+            stage = capturesOnly ? Stage::Done : Stage::Killers;
+            break;
+
+        case Stage::Killers:
+            // Only quiet moves are left, so a killer found among them is a quiet move of this position
+            while (history && ply < MoveHistory::MaxPly && killerSlot < 2) {
+                if (takeMatching(history->getKiller(ply, killerSlot++), move)) {
+                    return true;
+                }
+            }
+            stage = Stage::ScoreQuiet;
+            break;
+
+        case Stage::ScoreQuiet:
+            stageEnd = moves.count;
+            for (int i = current; i < stageEnd; i++) {
+                scores[i] = history ? history->getScore(board.getSideToMove(), moves.moves[i]) : 0;
+            }
+            stage = Stage::Quiet;
+            break;
+
+        case Stage::Quiet:
+            if (pickBest(move)) {
+                return true;
+            }
+            stage = Stage::Done;
+            break;
+
+        case Stage::Done:
+            return false;
+        }
+    }
+}
+
+// Most valuable victim, least valuable attacker. A queen promotion counts as winning a queen.
+int MovePicker::scoreNoisy(const Move& move) const {
+    int victim = static_cast<int>(Pieces::None);
+    if (move.flags & EnPassantFlag) {
+        victim = static_cast<int>(Pieces::Pawn);
+    }
+    else if (move.flags & CaptureFlag) {
+        victim = static_cast<int>(board.getPieceAt(move.getEnd()).getType());
+    }
+    if (move.promotion == Pieces::Queen) {
+        victim += static_cast<int>(Pieces::Queen);
+    }
+    int attacker = static_cast<int>(board.getPieceAt(move.getStart()).getType());
+    return victim * 8 - attacker;
+}
+
+// Hand out the best scored move of the stage. Equal scores keep the order of generation.
+bool MovePicker::pickBest(Move& move) {
+    if (current >= stageEnd) {
+        return false;
+    }
+    int best = current;
+    for (int i = current + 1; i < stageEnd; i++) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    // Rotate instead of swapping, so the moves after the best one stay in order
+    Move bestMove = moves.moves[best];
+    int bestScore = scores[best];
+    for (int i = best; i > current; i--) {
+        moves.moves[i] = moves.moves[i - 1];
+        scores[i] = scores[i - 1];
+    }
+    moves.moves[current] = bestMove;
+    scores[current] = bestScore;
+    move = moves.moves[current++];
+    return true;
+}
+
+// Hand out the given move if it is among the moves left. Only used before the remaining moves are scored.
+bool MovePicker::takeMatching(const Move& wanted, Move& move) {
+    if (wanted.from == wanted.to) {
+        return false;
+    }
+    for (int i = current; i < moves.count; i++) {
+        if (sameMove(moves.moves[i], wanted)) {
+            std::swap(moves.moves[i], moves.moves[current]);
+            move = moves.moves[current++];
+            return true;
+        }
+    }
+    return false;
+}
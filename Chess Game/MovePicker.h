@@ -0,0 +1,84 @@
+/*
+ * File: MovePicker.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the move ordering of the search: the killer and history heuristics, and the
+ *              staged picker that hands out the moves of a node best first.
+ */
+
+#pragma once
+
+#include "Classes.h"
+#include <cstdint>
+
+// What the search has learned about quiet moves so far: per ply, the two last quiet moves that caused a beta
+// cutoff (killer moves), and per side, start and end square, how often a quiet move caused a cutoff and how
+// deep (the butterfly history table). Each search thread keeps its own.
+class MoveHistory {
+public:
+    static const int MaxPly = 128;
+
+    MoveHistory() { clear(); }
+    void clear();
+
+    // A quiet move caused a beta cutoff: make it a killer of the ply, and reward it in the history table while
+    // penalizing the quiet moves tried before it in the same node
+    void addCutoff(Colors side, const Move& move, int depth, int ply, const Move* triedQuiets, int triedCount);
+
+    bool isKiller(const Move& move, int ply) const;
+    const Move& getKiller(int ply, int slot) const { return killers[ply][slot]; }
+    int getScore(Colors side, const Move& move) const { return history[colorIndex(side)][move.from][move.to]; }
+
+private:
+    // History scores stay within this bound, so old cutoffs fade as new ones are added
+    static const int MaxHistory = 1 << 14;
+
+    void update(Colors side, const Move& move, int bonus);
+
+    Move killers[MaxPly][2];
+    int history[2][64][64];
+};
+
+// Hands out the moves of a list one at a time, in the order the search should try them:
+//   1. the move from the transposition table
+//   2. captures and queen promotions, most valuable victim first and least valuable attacker among equal victims
+//   3. the killer moves of the ply
+//   4. the remaining quiet moves, by history score
+// A stage is only scored when the search reaches it, and each call picks the best remaining move of the stage
+// instead of sorting it, so a node that ends with a beta cutoff on an early move pays for little more than that
+// move. In captures-only mode (for the quiescence search) the picker stops after the captures.
+class MovePicker {
+public:
+    MovePicker(const Board& board, MoveList& moves, const Move& tableMove, const MoveHistory* history, int ply,
+        bool capturesOnly = false);
+
+    // Store the next move in move; false when there is none left
+    bool next(Move& move);
+
+    static bool isNoisy(const Move& move) {
+        return (move.flags & CaptureFlag) || move.promotion == Pieces::Queen;
+    }
+
+private:
+    enum class Stage { TableMove, ScoreNoisy, Noisy, Killers, ScoreQuiet, Quiet, Done };
+
+    int scoreNoisy(const Move& move) const;
+    bool pickBest(Move& move);
+    bool takeMatching(const Move& wanted, Move& move);
+
+    const Board& board;
+    MoveList& moves;
+    Move tableMove;
+    const MoveHistory* history;
+    int ply;
+    bool capturesOnly;
+    Stage stage = Stage::TableMove;
+    int killerSlot = 0;
+    int current = 0; // Moves before this index have been handed out
+    int stageEnd = 0; // End of the moves of the current stage
+    int scores[MaxMoves];
+};
+
+inline bool sameMove(const Move& a, const Move& b) {
+    return a.from == b.from && a.to == b.to && a.promotion == b.promotion;
+}
@@ -0,0 +1,172 @@
+/*
+ * File: OpeningBook.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the opening book lookup and builder.
+ */
+
+#include "OpeningBook.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    struct BookHeader {
+        char magic[4];  // "CGBK"
+        uint32_t version;
+        uint64_t count; // Entries after the header
+    };
+    static_assert(sizeof(BookHeader) == 16, "The header is written to the file as it is");
+
+    const char BookMagic[4] = { 'C', 'G', 'B', 'K' };
+    const uint32_t BookVersion = 1;
+
+    // The builder merges the moves it collected when it holds this many, so repeated moves take little memory
+    const size_t MergeThreshold = 1 << 22;
+
+    bool sameBookMove(const BookEntry& a, const BookEntry& b) {
+        return a.key == b.key && a.from == b.from && a.to == b.to && a.promotion == b.promotion;
+    }
+
+    bool byKeyAndMove(const BookEntry& a, const BookEntry& b) {
+        if (a.key != b.key) {
+            return a.key < b.key;
+        }
+        if (a.from != b.from) {
+            return a.from < b.from;
+        }
+        if (a.to != b.to) {
+            return a.to < b.to;
+        }
+        return a.promotion < b.promotion;
+    }
+
+    // Sort by key and add up the weights of each move, which then appears once
+    void mergeEntries(vector<BookEntry>& entries) {
+        sort(entries.begin(), entries.end(), byKeyAndMove);
+        size_t merged = 0;
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (merged > 0 && sameBookMove(entries[merged - 1], entries[i])) {
+                uint64_t weight = static_cast<uint64_t>(entries[merged - 1].weight) + entries[i].weight;
+                entries[merged - 1].weight = static_cast<uint32_t>(min<uint64_t>(weight, UINT32_MAX));
+            }
+            else {
+                entries[merged++] = entries[i];
+            }
+        }
+        entries.resize(merged);
+    }
+}
+
+bool OpeningBook::open(const char* path) {
+    close();
+    if (!file.open(path)) {
+        return false;
+    }
+    string_view text = file.text();
+    BookHeader header;
+    if (text.size() < sizeof(header)) {
+        close();
+        return false;
+    }
+    memcpy(&header, text.data(), sizeof(header));
+    // The count is checked against the size before it is multiplied, so a damaged count cannot overflow
+    size_t entryBytes = text.size() - sizeof(header);
+    if (memcmp(header.magic, BookMagic, sizeof(BookMagic)) != 0 || header.version != BookVersion
+        || header.count > entryBytes / sizeof(BookEntry) || header.count * sizeof(BookEntry) != entryBytes) {
+        close();
+        return false;
+    }
+    entries = reinterpret_cast<const BookEntry*>(text.data() + sizeof(header));
+    count = static_cast<size_t>(header.count);
+    return true;
+}
+
+void OpeningBook::close() {
+    file.close();
+    entries = nullptr;
+    count = 0;
+}
+
+int OpeningBook::findMoves(const Board& board, BookMove* moves, int maxMoves) const {
+    uint64_t key = board.getHashKey();
+    const BookEntry* first = lower_bound(entries, entries + count, key, [](const BookEntry& entry, uint64_t value) {
+        return entry.key < value;
+    });
+    if (first == entries + count || first->key != key) {
+        return 0;
+    }
+
+    MoveList legalMoves = board.generateLegalMoves(board.getSideToMove());
+    int found = 0;
+    for (const BookEntry* entry = first; entry < entries + count && entry->key == key && found < maxMoves; entry++) {
+        for (const Move& move : legalMoves) {
+            if (move.from == entry->from && move.to == entry->to && static_cast<uint8_t>(move.promotion) == entry->promotion) {
+                moves[found++] = { move, entry->weight };
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+bool OpeningBook::pickMove(const Board& board, uint64_t random, Move& move) const {
+    BookMove moves[MaxMoves];
+    int found = findMoves(board, moves, MaxMoves);
+    uint64_t total = 0;
+    for (int i = 0; i < found; i++) {
+        total += moves[i].weight;
+    }
+    if (total == 0) {
+        return false;
+    }
+    uint64_t pick = random % total;
+    for (int i = 0; i < found; i++) {
+        if (pick < moves[i].weight) {
+            move = moves[i].move;
+            return true;
+        }
+        pick -= moves[i].weight;
+    }
+    return false;
+}
+
+void OpeningBookBuilder::add(const Board& board, const Move& move) {
+    BookEntry entry = {};
+    entry.key = board.getHashKey();
+    entry.from = move.from;
+    entry.to = move.to;
+    entry.promotion = static_cast<uint8_t>(move.promotion);
+    entry.weight = 1;
+    entries.push_back(entry);
+    // Merge before the list grows; if little was merged away, let it grow anyway
+    if (entries.size() >= MergeThreshold && entries.size() == entries.capacity()) {
+        mergeEntries(entries);
+        if (entries.size() > entries.capacity() / 2) {
+            entries.reserve(entries.capacity() * 2);
+        }
+    }
+}
+
+long long OpeningBookBuilder::write(const char* path, uint32_t minWeight) {
+    mergeEntries(entries);
+    entries.erase(remove_if(entries.begin(), entries.end(), [minWeight](const BookEntry& entry) {
+        return entry.weight < minWeight;
+    }), entries.end());
+    // Most played first within each position
+    stable_sort(entries.begin(), entries.end(), [](const BookEntry& a, const BookEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.weight > b.weight;
+    });
+
+    BookHeader header = {};
+    memcpy(header.magic, BookMagic, sizeof(BookMagic));
+    header.version = BookVersion;
+    header.count = entries.size();
+    ofstream file(path, ios::binary);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.data()), static_cast<streamsize>(entries.size() * sizeof(BookEntry)));
+    if (!file) {
+        return -1;
+    }
+    return static_cast<long long>(entries.size());
+}
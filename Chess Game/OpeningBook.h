@@ -0,0 +1,72 @@
+/*
+ * File: OpeningBook.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the binary opening book: its memory-mapped lookup and its builder.
+ */
+
+#pragma once
+
+#include "Classes.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// A book file is a 16 byte header followed by fixed-size entries sorted by position key, so a lookup is a binary
+// search of the mapped file. Opening a book only maps it: nothing is read or allocated up front, and the operating
+// system pages in the few parts a lookup touches, so opening costs the same whatever the size of the book.
+// Numbers are stored in the byte order of the machine that wrote the book, so that the entries can be searched
+// in place. A book written on a machine of the other byte order shows a wrong version and does not open.
+struct BookEntry {
+    uint64_t key;      // Zobrist key of the position (Board::getHashKey)
+    uint8_t from;
+    uint8_t to;
+    uint8_t promotion; // Pieces value of the promotion, Pieces::None for other moves
+    uint8_t reserved;
+    uint32_t weight;   // Times the move was played from the position
+};
+static_assert(sizeof(BookEntry) == 16, "Book entries are written to the file as they are");
+
+struct BookMove {
+    Move move;
+    uint32_t weight;
+};
+
+class OpeningBook {
+public:
+    // Map a book file. Returns false if it cannot be mapped or is not a book.
+    bool open(const char* path);
+    void close();
+
+    size_t entryCount() const { return count; }
+
+    // Store the book moves of the position, most played first, and return how many there are. Only moves that
+    // are legal in the position are returned, so a key shared by two positions cannot give a wrong move.
+    int findMoves(const Board& board, BookMove* moves, int maxMoves) const;
+
+    // Pick one of the book moves of the position, each as likely as its share of the weights. random is any
+    // random number. Returns false if the position is not in the book.
+    bool pickMove(const Board& board, uint64_t random, Move& move) const;
+
+private:
+    MappedFile file;
+    const BookEntry* entries = nullptr;
+    size_t count = 0;
+};
+
+// Collects the moves played in games, then writes them as a book
+class OpeningBookBuilder {
+public:
+    // The move is played from the board's position
+    void add(const Board& board, const Move& move);
+
+    // Merge the moves collected, leave out those played fewer than minWeight times, and write the book. Returns
+    // the number of entries written, or -1 if the file cannot be written.
+    long long write(const char* path, uint32_t minWeight = 1);
+
+    size_t movesAdded() const { return entries.size(); }
+
+private:
+    vector<BookEntry> entries; // One per move added, merged when the book is written
+};
@@ -0,0 +1,280 @@
+/*
+ * File: PGN.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of reading PGN games and resolving SAN moves.
+ */
+
+#include "PGN.h"
+#include <algorithm>
+
+namespace {
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+    }
+
+    bool isResult(string_view token) {
+        return token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*";
+    }
+
+    Pieces pieceFromSAN(char letter) {
+        switch (letter) {
+        case 'N': return Pieces::Knight;
+        case 'B': return Pieces::Bishop;
+        case 'R': return Pieces::Rook;
+        case 'Q': return Pieces::Queen;
+        case 'K': return Pieces::King;
+        default: return Pieces::None;
+        }
+    }
+
+    // Read one line without its line ending. Returns false at the end of the input.
+    bool readLine(istream& in, string& line) {
+        if (!getline(in, line)) {
+            return false;
+        }
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        return true;
+    }
+
+    // Store the value of a tag line such as [Result "1-0"] if it is one the game needs
+    void readTag(const string& line, PGNGame& game) {
+        size_t nameEnd = line.find_first_of(" \t", 1);
+        size_t valueStart = line.find('"');
+        size_t valueEnd = line.rfind('"');
+        if (nameEnd == string::npos || valueStart == string::npos || valueEnd <= valueStart) {
+            return;
+        }
+        string_view name = string_view(line).substr(1, nameEnd - 1);
+        string value = line.substr(valueStart + 1, valueEnd - valueStart - 1);
+        if (name == "FEN") {
+            game.fen = value;
+        }
+        else if (name == "Result") {
+            game.result = value;
+        }
+    }
+}
+
+bool readPGNGame(istream& in, PGNGame& game) {
+    game.fen.clear();
+    game.result.assign(1, '*');
+    game.movetext.clear();
+
+    // Skip the blank lines before the game
+    string line;
+    do {
+        if (!readLine(in, line)) {
+            return false;
+        }
+    } while (line.find_first_not_of(" \t") == string::npos);
+
+    // Tag pairs, one per line, followed by blank lines unless the game has no movetext
+    while (line[0] == '[') {
+        readTag(line, game);
+        if (!readLine(in, line)) {
+            line.clear();
+            break;
+        }
+    }
+    while (line.find_first_not_of(" \t") == string::npos && in.peek() != '[' && readLine(in, line)) {
+    }
+
+    // Movetext, up to a blank line or the tags of the next game. Lines starting with % are escaped.
+    while (line.find_first_not_of(" \t") != string::npos) {
+        if (line[0] != '%') {
+            // Keep the line breaks: a ; comment runs to the end of its line only
+            game.movetext += line;
+            game.movetext += '\n';
+        }
+        if (in.peek() == '[' || !readLine(in, line)) {
+            break;
+        }
+    }
+    game.number++;
+    return true;
+}
+
+PGNToken PGNTokenizer::next() {
+    PGNToken token;
+    while (true) {
+        while (position < text.size() && isSpace(text[position])) {
+            position++;
+        }
+        if (position >= text.size()) {
+            return token;
+        }
+
+        size_t start = position;
+        char first = text[position];
+        if (first == '%' && (start == 0 || text[start - 1] == '\n')) {
+            // Escaped line, ignored
+            size_t end = text.find('\n', start);
+            position = (end == string_view::npos) ? text.size() : end + 1;
+            continue;
+        }
+        if (first == '[') {
+            // [Name "Value"], where the value may hold escaped quotes
+            size_t end = text.find(']', start);
+            end = (end == string_view::npos) ? text.size() : end;
+            size_t nameEnd = start + 1;
+            while (nameEnd < end && !isSpace(text[nameEnd]) && text[nameEnd] != '"') {
+                nameEnd++;
+            }
+            size_t valueStart = text.find('"', nameEnd);
+            size_t valueEnd = valueStart;
+            if (valueStart != string_view::npos && valueStart < end) {
+                valueEnd = valueStart + 1;
+                while (valueEnd < text.size() && text[valueEnd] != '"') {
+                    valueEnd += (text[valueEnd] == '\\') ? 2 : 1;
+                }
+                valueEnd = min(valueEnd, text.size());
+                end = text.find(']', valueEnd);
+                end = (end == string_view::npos) ? text.size() : end;
+                token.value = text.substr(valueStart + 1, valueEnd - valueStart - 1);
+            }
+            token.type = PGNTokenType::Tag;
+            token.text = text.substr(start + 1, nameEnd - start - 1);
+            position = min(end + 1, text.size());
+            return token;
+        }
+        if (first == '{' || first == ';') {
+            size_t end = text.find(first == '{' ? '}' : '\n', start);
+            end = (end == string_view::npos) ? text.size() : end;
+            token.type = PGNTokenType::Comment;
+            token.text = text.substr(start + 1, end - start - 1);
+            position = min(end + 1, text.size());
+            return token;
+        }
+        if (first == '(' || first == ')') {
+            position++;
+            if (first == '(') {
+                variationDepth++;
+                token.type = PGNTokenType::VariationStart;
+            }
+            else {
+                variationDepth = max(variationDepth - 1, 0);
+                token.type = PGNTokenType::VariationEnd;
+            }
+            token.text = text.substr(start, 1);
+            return token;
+        }
+
+        // A word: a move, a move number, a glyph or a termination marker
+        size_t end = start + 1;
+        while (end < text.size() && !isSpace(text[end]) && text[end] != '{' && text[end] != '(' && text[end] != ')'
+            && text[end] != ';' && text[end] != '[') {
+            end++;
+        }
+        position = end;
+        string_view word = text.substr(start, end - start);
+        if (isResult(word)) {
+            token.type = PGNTokenType::Result;
+            token.text = word;
+            return token;
+        }
+        if (first == '$') {
+            token.type = PGNTokenType::NAG;
+            token.text = word;
+            return token;
+        }
+        // A move number, possibly written against its move as in "12.e4"
+        size_t digits = 0;
+        while (digits < word.size() && ((word[digits] >= '0' && word[digits] <= '9') || word[digits] == '.')) {
+            digits++;
+        }
+        if (digits > 0 && word.substr(0, 3) != "0-0") {
+            word.remove_prefix(digits);
+        }
+        if (!word.empty()) {
+            token.type = PGNTokenType::Move;
+            token.text = word;
+            return token;
+        }
+    }
+}
+
+bool parseSAN(const Board& board, string_view san, Move& move) {
+    // Check, mate and annotation marks are not needed to find the move
+    while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?')) {
+        san.remove_suffix(1);
+    }
+    MoveList moves = board.generateLegalMoves(board.getSideToMove());
+
+    // Castling names the side only
+    if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+        int kingEndCol = (san.size() == 3) ? 6 : 2;
+        for (const Move& candidate : moves) {
+            if ((candidate.flags & CastlingFlag) && candidate.to % 8 == kingEndCol) {
+                move = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Moving piece, pawn when no letter is given
+    Pieces piece = Pieces::Pawn;
+    if (!san.empty() && pieceFromSAN(san[0]) != Pieces::None) {
+        piece = pieceFromSAN(san[0]);
+        san.remove_prefix(1);
+    }
+
+    // Promotion piece, written "e8=Q" or "e8Q"
+    Pieces promotion = Pieces::None;
+    if (piece == Pieces::Pawn && !san.empty() && pieceFromSAN(san.back()) != Pieces::None) {
+        promotion = pieceFromSAN(san.back());
+        san.remove_suffix(1);
+        if (!san.empty() && san.back() == '=') {
+            san.remove_suffix(1);
+        }
+    }
+
+    // Destination square
+    if (san.size() < 2) {
+        return false;
+    }
+    char file = san[san.size() - 2], rank = san[san.size() - 1];
+    if (file < 'a' || file > 'h' || rank < '1' || rank > '8') {
+        return false;
+    }
+    int to = squareIndex(rank - '1', file - 'a');
+    san.remove_suffix(2);
+
+    // What is left is the capture mark and the file and/or rank of the starting square, when needed
+    int fromCol = -1, fromRow = -1;
+    for (char c : san) {
+        if (c >= 'a' && c <= 'h') {
+            fromCol = c - 'a';
+        }
+        else if (c >= '1' && c <= '8') {
+            fromRow = c - '1';
+        }
+        else if (c != 'x' && c != ':') {
+            return false;
+        }
+    }
+
+    int found = 0;
+    for (const Move& candidate : moves) {
+        if (candidate.to == to && candidate.promotion == promotion
+            && board.getPieceAt(candidate.getStart()).getType() == piece
+            && (fromCol < 0 || candidate.from % 8 == fromCol) && (fromRow < 0 || candidate.from / 8 == fromRow)) {
+            move = candidate;
+            found++;
+        }
+    }
+    return found == 1;
+}
+
+bool parseSAN(const Board& board, string_view san, Position& start, Position& end) {
+    Move move;
+    if (!parseSAN(board, san, move)) {
+        return false;
+    }
+    start = move.getStart();
+    end = move.getEnd();
+    return true;
+}
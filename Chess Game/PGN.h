@@ -0,0 +1,65 @@
+/*
+ * File: PGN.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the reading and tokenizing of games in Portable Game Notation, and of SAN moves.
+ */
+
+#pragma once
+
+#include "Classes.h"
+#include <istream>
+#include <string>
+#include <string_view>
+
+// A game read from a PGN file: the tags needed to replay and judge it, and the movetext
+struct PGNGame {
+    long long number = 0; // Games read into this object so far: 1 for the first game of the file
+    string fen;           // FEN tag, empty when the game starts from the standard position
+    string result;        // Result tag, "*" when there is none
+    string movetext;
+};
+
+// Read the next game of the input. Returns false when there are no games left. Only the game being
+// read is held in memory, so files of any size can be streamed.
+bool readPGNGame(istream& in, PGNGame& game);
+
+// Kinds of tokens in PGN text
+enum class PGNTokenType {
+    Tag,            // Tag pair: text is the name, value the value without its quotes
+    Move,           // SAN move, with any move number in front of it removed
+    Comment,        // Text of a {...} or ; comment
+    NAG,            // Numeric annotation glyph such as $1
+    VariationStart, // ( opening a variation
+    VariationEnd,   // ) closing a variation
+    Result,         // Game termination marker: 1-0, 0-1, 1/2-1/2 or *
+    End             // No text left
+};
+
+struct PGNToken {
+    PGNTokenType type = PGNTokenType::End;
+    string_view text;
+    string_view value;
+};
+
+// Splits PGN text, a single movetext or a whole file of games, into tokens. The tokens point into the text,
+// so nothing is copied and the text must outlive them.
+class PGNTokenizer {
+public:
+    explicit PGNTokenizer(string_view text) : text(text) {}
+
+    PGNToken next();
+
+    // True while the tokens come from a variation rather than the moves of the game
+    bool inVariation() const { return variationDepth > 0; }
+
+private:
+    string_view text;
+    size_t position = 0;
+    int variationDepth = 0;
+};
+
+// Find the legal move of the side to move written in Standard Algebraic Notation, e.g. "Nbd7", "exd5",
+// "O-O" or "e8=Q+". Returns false if the text does not name exactly one legal move.
+bool parseSAN(const Board& board, string_view san, Move& move);
+bool parseSAN(const Board& board, string_view san, Position& start, Position& end);
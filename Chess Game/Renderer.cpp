@@ -0,0 +1,127 @@
+/*
+ * File: Renderer.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the buffered board renderer, in plain and ANSI mode.
+ */
+
+#include "Renderer.h"
+
+namespace {
+    // Row labels as shown by the interactive game, which numbers the rows the other way round from FEN
+    const char RowLabels[8] = { '8', '7', '6', '5', '4', '3', '2', '1' };
+
+    // Each square is drawn as an 8 character cell, e.g. "[P, e7] " or "[   e5] "
+    const int CellWidth = 8;
+
+    // The board takes the top 8 lines of the terminal in ANSI mode; the scrolling text starts below a blank line
+    const int TextTopLine = 10;
+
+    char* writeText(char* out, const char* text) {
+        while (*text) {
+            *out++ = *text++;
+        }
+        return out;
+    }
+
+    char* writeNumber(char* out, int number) {
+        if (number >= 10) {
+            out = writeNumber(out, number / 10);
+        }
+        *out++ = static_cast<char>('0' + number % 10);
+        return out;
+    }
+
+    char* writeCell(char* out, Piece piece, int row, int col) {
+        *out++ = '[';
+        if (piece) {
+            *out++ = piece.getSymbol();
+            *out++ = ',';
+            *out++ = ' ';
+        }
+        else {
+            out = writeText(out, "   ");
+        }
+        *out++ = static_cast<char>('a' + col);
+        *out++ = RowLabels[row];
+        *out++ = ']';
+        *out++ = ' ';
+        return out;
+    }
+
+    // Move the cursor to a line and column of the terminal, both counted from 1
+    char* writeCursorMove(char* out, int line, int column) {
+        out = writeText(out, "\x1b[");
+        out = writeNumber(out, line);
+        *out++ = ';';
+        out = writeNumber(out, column);
+        *out++ = 'H';
+        return out;
+    }
+
+    // Terminal line of a board row: the board is drawn from row 7 at the top down to row 0
+    int lineOfRow(int row) {
+        return 8 - row;
+    }
+}
+
+void BoardRenderer::render(const Board& board, ostream& out) {
+    char* end = (ansi && hasFrame) ? writeChanges(board, buffer) : writeFullFrame(board, buffer);
+    frameSize = static_cast<size_t>(end - buffer);
+    if (frameSize > 0) {
+        out.write(buffer, static_cast<streamsize>(frameSize));
+        out.flush();
+    }
+}
+
+void BoardRenderer::finish(ostream& out) {
+    if (ansi && hasFrame) {
+        // Setting the scrolling region moves the cursor home, so keep it where the text ended
+        out << "\x1b" "7" "\x1b[r" "\x1b" "8" << flush;
+    }
+    hasFrame = false;
+}
+
+char* BoardRenderer::writeFullFrame(const Board& board, char* out) {
+    if (ansi) {
+        out = writeText(out, "\x1b[2J\x1b[H"); // Clear the terminal and go to its top left corner
+    }
+    for (int row = 7; row >= 0; row--) {
+        for (int col = 0; col < 8; col++) {
+            Piece piece = board.getPieceAt(Position(row, col));
+            shown[squareIndex(row, col)] = piece;
+            out = writeCell(out, piece, row, col);
+        }
+        *out++ = '\n';
+    }
+    if (ansi) {
+        // Text scrolls from the line below the board to the bottom of the terminal, leaving the board in place
+        out = writeText(out, "\x1b[");
+        out = writeNumber(out, TextTopLine);
+        *out++ = 'r';
+        out = writeCursorMove(out, TextTopLine, 1);
+        hasFrame = true;
+    }
+    return out;
+}
+
+char* BoardRenderer::writeChanges(const Board& board, char* out) {
+    char* start = out;
+    out = writeText(out, "\x1b" "7"); // Save the cursor position in the text below the board
+    bool changed = false;
+    for (int square = 0; square < 64; square++) {
+        int row = square / 8, col = square % 8;
+        Piece piece = board.getPieceAt(Position(row, col));
+        if (piece == shown[square]) {
+            continue;
+        }
+        shown[square] = piece;
+        changed = true;
+        out = writeCursorMove(out, lineOfRow(row), 1 + col * CellWidth);
+        out = writeCell(out, piece, row, col);
+    }
+    if (!changed) {
+        return start;
+    }
+    return writeText(out, "\x1b" "8"); // Back to where the text was
+}
@@ -0,0 +1,44 @@
+/*
+ * File: Renderer.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the board renderer, which writes each frame to the console at once.
+ */
+
+#pragma once
+
+#include "Classes.h"
+#include <cstddef>
+#include <ostream>
+
+// Draws the board. Each frame is built in a buffer inside the renderer and written with a single write.
+//
+// In plain mode every frame is the whole board, one line per row. In ANSI mode the first frame clears the
+// terminal and draws the board on its top lines, and the lines below it become a scrolling region for the
+// rest of the output; later frames move the cursor to each square that changed since the previous frame
+// and redraw only those, so a move costs a few dozen bytes instead of a whole board.
+class BoardRenderer {
+public:
+    explicit BoardRenderer(bool ansi = false) : ansi(ansi) {}
+
+    void render(const Board& board, ostream& out);
+
+    // ANSI mode: give the whole terminal back to scrolling text. The next frame is drawn in full.
+    void finish(ostream& out);
+
+    // Bytes written by the last render
+    size_t lastFrameSize() const { return frameSize; }
+
+private:
+    // Large enough for a full ANSI frame, or for redrawing all 64 squares one by one
+    static const size_t BufferSize = 2048;
+
+    char* writeFullFrame(const Board& board, char* out);
+    char* writeChanges(const Board& board, char* out);
+
+    bool ansi;
+    bool hasFrame = false; // Whether shown holds the board on the terminal
+    Piece shown[64];
+    char buffer[BufferSize];
+    size_t frameSize = 0;
+};
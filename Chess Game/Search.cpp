@@ -0,0 +1,289 @@
+/*
+ * File: Search.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the alpha-beta search.
+ */
+
+#include "Search.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace {
+    // How many nodes to search between checks of the time and node budget
+    const uint64_t BudgetCheckInterval = 1024;
+
+    // Depth skipping pattern of the helper threads of a parallel search, cycled by thread: helper i skips
+    // the depths where (depth + SkipPhase[i]) / SkipSize[i] is odd
+    const int SkipPatterns = 20;
+    const int SkipSize[SkipPatterns] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+    const int SkipPhase[SkipPatterns] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
+    // Mate scores count plies from the root, but an entry can be found again at any ply, so the table
+    // stores them counted from the position itself
+    int scoreToTable(int score, int ply) {
+        if (score >= MateScore - MaxSearchDepth * 2) {
+            return score + ply;
+        }
+        if (score <= -(MateScore - MaxSearchDepth * 2)) {
+            return score - ply;
+        }
+        return score;
+    }
+
+    int scoreFromTable(int score, int ply) {
+        if (score >= MateScore - MaxSearchDepth * 2) {
+            return score - ply;
+        }
+        if (score <= -(MateScore - MaxSearchDepth * 2)) {
+            return score + ply;
+        }
+        return score;
+    }
+}
+
+int evaluate(const Board& board) {
+    // Kept up to date by the board as moves are made and taken back
+    return board.getEvaluation();
+}
+
+SearchResult Search::run(Board& searchBoard, const SearchLimits& searchLimits) {
+    if (table) {
+        table->newSearch();
+    }
+    return iterate(searchBoard, searchLimits);
+}
+
+SearchResult Search::runParallel(const Board& board, const SearchLimits& limits, TranspositionTable& table, int threads) {
+    table.newSearch();
+    std::atomic<bool> stop{ false };
+    std::vector<SearchResult> results(std::max(threads, 1));
+
+    // Each thread searches its own board, built from a snapshot of the position. Unlike a copy of the board,
+    // the snapshot leaves the undo stack behind, which the search never takes back.
+    BoardSnapshot snapshot;
+    board.saveSnapshot(snapshot);
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; i++) {
+        helpers.emplace_back([&snapshot, &limits, &table, &stop, &results, i]() {
+            Board helperBoard(snapshot);
+            Search helper(&table);
+            helper.threadIndex = i;
+            helper.stopSignal = &stop;
+            results[i] = helper.iterate(helperBoard, limits);
+        });
+    }
+
+    Board mainBoard(snapshot);
+    Search main(&table);
+    results[0] = main.iterate(mainBoard, limits);
+    stop.store(true, std::memory_order_relaxed);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    SearchResult result = results[0];
+    for (int i = 1; i < threads; i++) {
+        result.nodes += results[i].nodes;
+        result.tableStats += results[i].tableStats;
+        result.cutoffStats += results[i].cutoffStats;
+    }
+    return result;
+}
+
+bool Search::skipsDepth(int depth) const {
+    if (threadIndex == 0) {
+        return false;
+    }
+    int pattern = (threadIndex - 1) % SkipPatterns;
+    return ((depth + SkipPhase[pattern]) / SkipSize[pattern]) % 2 != 0;
+}
+
+// Search deeper one ply at a time until a limit is reached, keeping the result of the last complete iteration
+SearchResult Search::iterate(Board& searchBoard, const SearchLimits& searchLimits) {
+    board = &searchBoard;
+    limits = searchLimits;
+    nodes = 0;
+    stopped = false;
+    startTime = std::chrono::steady_clock::now();
+    rootBestMove = {};
+    tableStats = TTStats();
+    cutoffStats = CutoffStats();
+    history.clear();
+
+    SearchResult result;
+    int maxDepth = std::min(limits.depth, MaxSearchDepth);
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        // A helper always searches the last depth, so it keeps working until the main thread is done
+        if (depth < maxDepth && skipsDepth(depth)) {
+            continue;
+        }
+        int score = negamax(depth, -InfiniteScore, InfiniteScore, 0);
+        // An interrupted iteration is thrown away, unless nothing was searched before it
+        if (stopped && result.depth > 0) {
+            break;
+        }
+        result.bestMove = rootBestMove;
+        result.score = score;
+        result.depth = depth;
+        // A forced mate will not be improved by searching deeper
+        if (stopped || std::abs(score) >= MateScore - MaxSearchDepth) {
+            break;
+        }
+    }
+
+    result.nodes = nodes;
+    result.tableStats = tableStats;
+    result.cutoffStats = cutoffStats;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+bool Search::outOfBudget() {
+    if (stopSignal && stopSignal->load(std::memory_order_relaxed)) {
+        return true;
+    }
+    if (limits.nodes > 0 && nodes >= limits.nodes) {
+        return true;
+    }
+    return limits.seconds > 0
+        && std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count() >= limits.seconds;
+}
+
+int Search::negamax(int depth, int alpha, int beta, int ply) {
+    nodes++;
+    if (nodes % BudgetCheckInterval == 0 && outOfBudget()) {
+        stopped = true;
+    }
+    if (stopped) {
+        return 0;
+    }
+
+    // Fifty-move rule and repetitions. Inside the search one repetition is enough to call it a draw,
+    // since the side that could avoid it would have done so.
+    if (ply > 0 && (board->getHalfmoveClock() >= 100 || board->countRepetitions(1) > 0)) {
+        return 0;
+    }
+    if (depth <= 0) {
+        return quiescence(alpha, beta, ply);
+    }
+
+    // A result from the table that is deep enough and bounds the score outside the window ends the search
+    // here. Otherwise its best move is searched first. The root is always searched, so it has a best move.
+    Move tableMove = {};
+    if (table) {
+        TTEntry entry;
+        tableStats.probes++;
+        if (table->probe(board->getHashKey(), entry)) {
+            tableStats.hits++;
+            tableMove = entry.move;
+            int score = scoreFromTable(entry.score, ply);
+            if (ply > 0 && entry.depth >= depth
+                && (entry.bound == Bound::Exact
+                    || (entry.bound == Bound::Lower && score >= beta)
+                    || (entry.bound == Bound::Upper && score <= alpha))) {
+                tableStats.cutoffs++;
+                return score;
+            }
+        }
+    }
+
+    Colors side = board->getSideToMove();
+    MoveList moves = board->generateLegalMoves(side);
+    if (moves.count == 0) {
+        return board->isInCheck(side) ? -(MateScore - ply) : 0; // Checkmate or stalemate
+    }
+    MovePicker picker(*board, moves, (ply == 0 && rootBestMove.from != rootBestMove.to) ? rootBestMove : tableMove,
+        &history, ply);
+
+    int originalAlpha = alpha;
+    int bestScore = -InfiniteScore;
+    Move bestMove = {};
+    Move triedQuiets[MaxMoves];
+    int triedQuietCount = 0;
+    int movesTried = 0;
+    Move move;
+    while (picker.next(move)) {
+        board->makeMove(move);
+        int score = -negamax(depth - 1, -beta, -alpha, ply + 1);
+        board->unmakeMove();
+        if (stopped) {
+            return 0;
+        }
+        movesTried++;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestMove = move;
+            if (ply == 0) {
+                rootBestMove = move;
+            }
+        }
+        alpha = std::max(alpha, score);
+        if (alpha >= beta) {
+            // The opponent will not allow this position. A quiet move that refutes it is likely to refute
+            // the opponent's other moves too.
+            cutoffStats.cutoffs++;
+            if (movesTried == 1) {
+                cutoffStats.firstMoveCutoffs++;
+            }
+            if (!MovePicker::isNoisy(move)) {
+                history.addCutoff(side, move, depth, ply, triedQuiets, triedQuietCount);
+            }
+            break;
+        }
+        if (!MovePicker::isNoisy(move)) {
+            triedQuiets[triedQuietCount++] = move;
+        }
+    }
+
+    if (table) {
+        TTEntry entry;
+        entry.move = bestMove;
+        entry.score = scoreToTable(bestScore, ply);
+        entry.depth = depth;
+        entry.bound = (bestScore <= originalAlpha) ? Bound::Upper : (bestScore >= beta) ? Bound::Lower : Bound::Exact;
+        tableStats.stores++;
+        if (table->store(board->getHashKey(), entry) == TTStore::Replaced) {
+            tableStats.replacements++;
+        }
+    }
+    return bestScore;
+}
+
+// Search only captures until the position is quiet, so the evaluation is not taken in the middle of an exchange
+int Search::quiescence(int alpha, int beta, int ply) {
+    nodes++;
+    if (nodes % BudgetCheckInterval == 0 && outOfBudget()) {
+        stopped = true;
+    }
+    if (stopped) {
+        return 0;
+    }
+
+    // The side to move can usually do at least as well as the static evaluation by not capturing
+    int standPat = evaluate(*board);
+    if (standPat >= beta || ply >= MaxSearchDepth * 2) {
+        return standPat;
+    }
+    alpha = std::max(alpha, standPat);
+
+    MoveList moves = board->generateLegalMoves(board->getSideToMove());
+    MovePicker picker(*board, moves, Move{}, nullptr, ply, true);
+    Move move;
+    while (picker.next(move)) {
+        board->makeMove(move);
+        int score = -quiescence(-beta, -alpha, ply + 1);
+        board->unmakeMove();
+        if (stopped) {
+            return 0;
+        }
+
+        if (score >= beta) {
+            return score;
+        }
+        alpha = std::max(alpha, score);
+    }
+    return alpha;
+}
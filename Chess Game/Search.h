@@ -0,0 +1,92 @@
+/*
+ * File: Search.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the alpha-beta search that picks a move for the side to move.
+ */
+
+#pragma once
+
+#include "Classes.h"
+#include "MovePicker.h"
+#include "TranspositionTable.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Scores are in centipawns from the point of view of the side to move. Being mated n plies from the
+// root scores -(MateScore - n), so shorter mates score higher for the winner.
+const int MateScore = 30000;
+const int InfiniteScore = 32000;
+const int MaxSearchDepth = 64;
+
+// When to stop searching. The search stops at whichever limit is reached first.
+struct SearchLimits {
+    int depth = MaxSearchDepth;
+    uint64_t nodes = 0;  // 0 for no node limit. In a parallel search the limit applies to each thread.
+    double seconds = 0;  // 0 for no time limit
+};
+
+// How well the moves were ordered: the share of beta cutoffs made by the first move searched. Counted by each
+// search thread for itself.
+struct CutoffStats {
+    uint64_t cutoffs = 0;
+    uint64_t firstMoveCutoffs = 0;
+
+    double firstMoveRate() const { return cutoffs ? static_cast<double>(firstMoveCutoffs) / cutoffs : 0; }
+
+    CutoffStats& operator+=(const CutoffStats& other) {
+        cutoffs += other.cutoffs;
+        firstMoveCutoffs += other.firstMoveCutoffs;
+        return *this;
+    }
+};
+
+struct SearchResult {
+    Move bestMove = {};  // from == to when the side to move has no legal move
+    int score = 0;
+    int depth = 0;       // Deepest iteration that was searched completely
+    uint64_t nodes = 0;  // Summed over all threads of a parallel search
+    double seconds = 0;
+    TTStats tableStats;
+    CutoffStats cutoffStats;
+};
+
+// Static evaluation of the position for the side to move
+int evaluate(const Board& board);
+
+// Negamax alpha-beta search with iterative deepening and a quiescence search of captures at the leaves.
+// The board is used as a scratch pad (moves are made and taken back) and is left as it was given.
+// Results are cached in the transposition table, if one is given; it may be shared with other searches.
+class Search {
+public:
+    explicit Search(TranspositionTable* table = nullptr) : table(table) {}
+
+    SearchResult run(Board& board, const SearchLimits& limits);
+
+    // Lazy SMP: the given number of threads search the same root, each with its own copy of the board,
+    // sharing the table. Helper threads skip some depths of the iterative deepening so they work ahead at
+    // different depths and fill the table for the main thread, whose result is returned. The search stops
+    // when the main thread does.
+    static SearchResult runParallel(const Board& board, const SearchLimits& limits, TranspositionTable& table, int threads);
+
+private:
+    SearchResult iterate(Board& board, const SearchLimits& limits);
+    bool skipsDepth(int depth) const;
+    int negamax(int depth, int alpha, int beta, int ply);
+    int quiescence(int alpha, int beta, int ply);
+    bool outOfBudget();
+
+    Board* board = nullptr;
+    TranspositionTable* table;
+    TTStats tableStats;
+    CutoffStats cutoffStats;
+    MoveHistory history;                          // Killer moves and history scores, kept for the whole search
+    int threadIndex = 0;                          // 0 for the main thread
+    const std::atomic<bool>* stopSignal = nullptr; // Set when helper threads must stop
+    SearchLimits limits;
+    uint64_t nodes = 0;
+    bool stopped = false;
+    std::chrono::steady_clock::time_point startTime;
+    Move rootBestMove = {};
+};
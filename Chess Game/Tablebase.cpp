@@ -0,0 +1,914 @@
+/*
+ * File: Tablebase.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the endgame tablebases: position indexing, the parallel retrograde generator,
+ *              the table files and the probe.
+ */
+
+#include "Tablebase.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Piece types other than the king, in the order they are written in material names
+    const Pieces NamedTypes[5] = { Pieces::Queen, Pieces::Rook, Pieces::Bishop, Pieces::Knight, Pieces::Pawn };
+    const char NamedLetters[5] = { 'Q', 'R', 'B', 'N', 'P' };
+    const int NamedValues[5] = { 9, 5, 3, 3, 1 };
+
+    // Distances to mate are stored as plies + 1 in one byte, 0 meaning a draw
+    const int MaxStoredPlies = 254;
+
+    const uint64_t InvalidIndex = ~0ULL;
+
+    // Pieces of each color index and type; the kings are not counted
+    struct Material {
+        int count[2][7] = {};
+
+        int pieces() const {
+            int total = 0;
+            for (int color = 0; color < 2; color++) {
+                for (Pieces type : NamedTypes) {
+                    total += count[color][static_cast<int>(type)];
+                }
+            }
+            return total;
+        }
+
+        bool hasPawns() const {
+            return count[0][static_cast<int>(Pieces::Pawn)] + count[1][static_cast<int>(Pieces::Pawn)] > 0;
+        }
+
+        // Four bits per color and type
+        uint64_t key() const {
+            uint64_t key = 0;
+            for (int color = 0; color < 2; color++) {
+                for (Pieces type : NamedTypes) {
+                    key |= static_cast<uint64_t>(count[color][static_cast<int>(type)]) << (4 * (color * 7 + static_cast<int>(type)));
+                }
+            }
+            return key;
+        }
+
+        Material flipped() const {
+            Material other;
+            for (int type = 0; type < 7; type++) {
+                other.count[0][type] = count[1][type];
+                other.count[1][type] = count[0][type];
+            }
+            return other;
+        }
+
+        string name() const {
+            string name;
+            for (int color = 0; color < 2; color++) {
+                if (color == 1) {
+                    name += 'v';
+                }
+                name += 'K';
+                for (int i = 0; i < 5; i++) {
+                    name.append(count[color][static_cast<int>(NamedTypes[i])], NamedLetters[i]);
+                }
+            }
+            return name;
+        }
+    };
+
+    // Whether White's pieces are worth at least as much as Black's, comparing piece by piece on a tie
+    bool whiteIsStronger(const Material& material) {
+        int values[2] = { 0, 0 };
+        for (int color = 0; color < 2; color++) {
+            for (int i = 0; i < 5; i++) {
+                values[color] += NamedValues[i] * material.count[color][static_cast<int>(NamedTypes[i])];
+            }
+        }
+        if (values[0] != values[1]) {
+            return values[0] > values[1];
+        }
+        for (Pieces type : NamedTypes) {
+            if (material.count[0][static_cast<int>(type)] != material.count[1][static_cast<int>(type)]) {
+                return material.count[0][static_cast<int>(type)] > material.count[1][static_cast<int>(type)];
+            }
+        }
+        return true;
+    }
+
+    // The material as its table is named: stronger side as White
+    Material canonicalMaterial(const Material& material) {
+        return whiteIsStronger(material) ? material : material.flipped();
+    }
+
+    // Parse a material name such as "KRPvKR", in any letter order after each king
+    bool parseMaterial(string_view name, Material& material) {
+        material = Material();
+        size_t split = name.find('v');
+        if (split == string_view::npos) {
+            return false;
+        }
+        string_view sides[2] = { name.substr(0, split), name.substr(split + 1) };
+        for (int color = 0; color < 2; color++) {
+            if (sides[color].empty() || sides[color][0] != 'K') {
+                return false;
+            }
+            for (char letter : sides[color].substr(1)) {
+                const char* found = find(NamedLetters, NamedLetters + 5, letter);
+                if (found == NamedLetters + 5) {
+                    return false;
+                }
+                material.count[color][static_cast<int>(NamedTypes[found - NamedLetters])]++;
+            }
+        }
+        return material.pieces() + 2 <= MaxTablebasePieces;
+    }
+
+    // Materials reached from this one by a capture, a promotion, or a capture that promotes
+    vector<Material> childMaterials(const Material& material) {
+        vector<Material> children;
+        auto add = [&children](const Material& child) {
+            Material canonical = canonicalMaterial(child);
+            for (const Material& known : children) {
+                if (known.key() == canonical.key()) {
+                    return;
+                }
+            }
+            children.push_back(canonical);
+        };
+        for (int color = 0; color < 2; color++) {
+            for (Pieces captured : NamedTypes) {
+                if (material.count[color][static_cast<int>(captured)] > 0) {
+                    Material child = material;
+                    child.count[color][static_cast<int>(captured)]--;
+                    add(child);
+                }
+            }
+            if (material.count[color][static_cast<int>(Pieces::Pawn)] == 0) {
+                continue;
+            }
+            for (int i = 0; i < 4; i++) {
+                Material promoted = material;
+                promoted.count[color][static_cast<int>(Pieces::Pawn)]--;
+                promoted.count[color][static_cast<int>(NamedTypes[i])]++;
+                add(promoted);
+                for (Pieces captured : NamedTypes) {
+                    if (captured != Pieces::Pawn && material.count[1 - color][static_cast<int>(captured)] > 0) {
+                        Material child = promoted;
+                        child.count[1 - color][static_cast<int>(captured)]--;
+                        add(child);
+                    }
+                }
+            }
+        }
+        return children;
+    }
+
+    // Order of the pieces in a table's positions: the white king, the black king, then White's and Black's other
+    // pieces in name order. Identical pieces are next to each other, and their squares are kept sorted so that
+    // swapping them gives the same index.
+    struct Layout {
+        int count = 0;
+        int colors[MaxTablebasePieces] = {};
+        Pieces types[MaxTablebasePieces] = {};
+        int runStart[MaxTablebasePieces] = {}; // First piece identical to each piece
+        bool hasPawns = false;
+        uint64_t size = 0;                     // Positions per side to move
+    };
+
+    // The symmetries of the board as square maps, and the king placements each table stores. Without pawns the
+    // white king is kept in the a1-d1-d4 triangle (with the black king on or below the a1-h8 diagonal when the
+    // white king is on it); with pawns the white king is kept on files a to d. Kings next to each other are left
+    // out.
+    struct Symmetries {
+        int transform[8][64];
+        int kingSymmetries[2][64][2]; // [has pawns][white king]: the symmetries that bring the king to a stored square
+        int kingSymmetryCount[2][64];
+        int kingPair[2][64][64]; // [has pawns][white king][black king], -1 when not stored
+        int pairSquares[2][64 * 64][2];
+        int pairCount[2];
+    };
+
+    Symmetries buildSymmetries() {
+        Symmetries symmetries{};
+        for (int symmetry = 0; symmetry < 8; symmetry++) {
+            for (int square = 0; square < 64; square++) {
+                int row = square / 8, col = square % 8;
+                if (symmetry & 4) {
+                    swap(row, col);
+                }
+                if (symmetry & 1) {
+                    col = 7 - col;
+                }
+                if (symmetry & 2) {
+                    row = 7 - row;
+                }
+                symmetries.transform[symmetry][square] = row * 8 + col;
+            }
+        }
+        for (int pawns = 0; pawns < 2; pawns++) {
+            int pairs = 0;
+            for (int whiteKing = 0; whiteKing < 64; whiteKing++) {
+                for (int blackKing = 0; blackKing < 64; blackKing++) {
+                    int whiteRow = whiteKing / 8, whiteCol = whiteKing % 8;
+                    int blackRow = blackKing / 8, blackCol = blackKing % 8;
+                    bool touching = abs(whiteRow - blackRow) <= 1 && abs(whiteCol - blackCol) <= 1;
+                    bool stored = !touching && whiteCol <= 3;
+                    if (!pawns) {
+                        stored = stored && whiteRow <= whiteCol && (whiteRow != whiteCol || blackRow <= blackCol);
+                    }
+                    symmetries.kingPair[pawns][whiteKing][blackKing] = stored ? pairs : -1;
+                    if (stored) {
+                        symmetries.pairSquares[pawns][pairs][0] = whiteKing;
+                        symmetries.pairSquares[pawns][pairs][1] = blackKing;
+                        pairs++;
+                    }
+                }
+            }
+            symmetries.pairCount[pawns] = pairs;
+
+            for (int whiteKing = 0; whiteKing < 64; whiteKing++) {
+                for (int symmetry = 0; symmetry < (pawns ? 2 : 8); symmetry++) {
+                    int mapped = symmetries.transform[symmetry][whiteKing];
+                    bool stored = (mapped % 8 <= 3) && (pawns || mapped / 8 <= mapped % 8);
+                    if (stored) {
+                        symmetries.kingSymmetries[pawns][whiteKing][symmetries.kingSymmetryCount[pawns][whiteKing]++] = symmetry;
+                    }
+                }
+            }
+        }
+        return symmetries;
+    }
+
+    const Symmetries& symmetries() {
+        static const Symmetries tables = buildSymmetries();
+        return tables;
+    }
+
+    Layout makeLayout(const Material& material) {
+        Layout layout;
+        layout.colors[0] = 0;
+        layout.types[0] = Pieces::King;
+        layout.colors[1] = 1;
+        layout.types[1] = Pieces::King;
+        layout.count = 2;
+        for (int color = 0; color < 2; color++) {
+            for (Pieces type : NamedTypes) {
+                for (int i = 0; i < material.count[color][static_cast<int>(type)]; i++) {
+                    layout.colors[layout.count] = color;
+                    layout.types[layout.count] = type;
+                    layout.count++;
+                }
+            }
+        }
+        for (int i = 0; i < layout.count; i++) {
+            layout.runStart[i] = (i > 2 && layout.colors[i - 1] == layout.colors[i] && layout.types[i - 1] == layout.types[i])
+                ? layout.runStart[i - 1] : i;
+        }
+        layout.hasPawns = material.hasPawns();
+        layout.size = symmetries().pairCount[layout.hasPawns];
+        for (int i = 2; i < layout.count; i++) {
+            layout.size *= 64;
+        }
+        return layout;
+    }
+
+    // Index of a position given by the squares of its pieces in layout order: the smallest index over the
+    // symmetries that bring the kings to a stored placement. InvalidIndex if the kings touch.
+    uint64_t positionIndex(const Layout& layout, const int* squares) {
+        const Symmetries& tables = symmetries();
+        int pawns = layout.hasPawns ? 1 : 0;
+        uint64_t best = InvalidIndex;
+        for (int i = 0; i < tables.kingSymmetryCount[pawns][squares[0]]; i++) {
+            const int* transform = tables.transform[tables.kingSymmetries[pawns][squares[0]][i]];
+            int pair = tables.kingPair[pawns][transform[squares[0]]][transform[squares[1]]];
+            if (pair < 0) {
+                continue;
+            }
+            int mapped[MaxTablebasePieces];
+            uint64_t index = static_cast<uint64_t>(pair);
+            for (int i = 2; i < layout.count; i++) {
+                mapped[i] = transform[squares[i]];
+                for (int j = i; j > layout.runStart[i] && mapped[j - 1] > mapped[j]; j--) {
+                    swap(mapped[j - 1], mapped[j]);
+                }
+            }
+            for (int i = 2; i < layout.count; i++) {
+                index = index * 64 + static_cast<uint64_t>(mapped[i]);
+            }
+            best = min(best, index);
+        }
+        return best;
+    }
+
+    // Squares of the pieces of the position at an index
+    void positionSquares(const Layout& layout, uint64_t index, int* squares) {
+        for (int i = layout.count - 1; i >= 2; i--) {
+            squares[i] = static_cast<int>(index % 64);
+            index /= 64;
+        }
+        const int* kings = symmetries().pairSquares[layout.hasPawns][index];
+        squares[0] = kings[0];
+        squares[1] = kings[1];
+    }
+
+    Bitboard pieceAttacks(Pieces type, int color, int square, Bitboard occupied) {
+        switch (type) {
+        case Pieces::Pawn: return PawnAttacks[color][square];
+        case Pieces::Knight: return KnightAttacks[square];
+        case Pieces::Bishop: return bishopAttacks(square, occupied);
+        case Pieces::Rook: return rookAttacks(square, occupied);
+        case Pieces::Queen: return queenAttacks(square, occupied);
+        case Pieces::King: return KingAttacks[square];
+        default: return 0;
+        }
+    }
+
+    // Whether a piece of the given color, other than the one in slot skip, attacks the square
+    bool isAttacked(const Layout& layout, const int* squares, int square, int byColor, Bitboard occupied, int skip = -1) {
+        for (int i = 0; i < layout.count; i++) {
+            if (i != skip && layout.colors[i] == byColor
+                && (pieceAttacks(layout.types[i], byColor, squares[i], occupied) & squareBit(square))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Bitboard occupancy(const Layout& layout, const int* squares, int color = -1) {
+        Bitboard occupied = 0;
+        for (int i = 0; i < layout.count; i++) {
+            if (color < 0 || layout.colors[i] == color) {
+                occupied |= squareBit(squares[i]);
+            }
+        }
+        return occupied;
+    }
+
+    void decodeValue(uint8_t value, TablebaseResult& result) {
+        if (value == 0) {
+            result.outcome = TablebaseOutcome::Draw;
+            result.pliesToMate = 0;
+            return;
+        }
+        result.pliesToMate = value - 1;
+        result.outcome = (result.pliesToMate % 2 != 0) ? TablebaseOutcome::Win : TablebaseOutcome::Loss;
+    }
+
+    // Run the work on the given number of threads, passing each its number
+    template <typename Work>
+    void runOnThreads(int threads, Work work) {
+        vector<thread> helpers;
+        for (int i = 1; i < threads; i++) {
+            helpers.emplace_back(work, i);
+        }
+        work(0);
+        for (thread& helper : helpers) {
+            helper.join();
+        }
+    }
+
+    // Start of every table file
+    struct FileHeader {
+        char magic[4];      // "CGTB"
+        uint32_t version;
+        char material[16];  // Name of the material, padded with zeros
+        uint64_t positions; // Positions per side to move
+    };
+
+    const char FileMagic[4] = { 'C', 'G', 'T', 'B' };
+    const uint32_t FileVersion = 1;
+}
+
+struct Tablebases::Table {
+    Layout layout;
+    MappedFile file;
+    const uint8_t* values = nullptr; // White to move, then Black to move
+};
+
+// A position as a list of pieces in any order
+struct Tablebases::PieceList {
+    int count = 0;
+    int colors[MaxTablebasePieces];
+    Pieces types[MaxTablebasePieces];
+    int squares[MaxTablebasePieces];
+    int sideToMove = 0; // Color index
+};
+
+// Retrograde analysis of one material. Every legal position first gets the number of its moves that stay in the
+// table; moves that capture or promote leave it, and their outcome is read from the smaller tables. Then, ply by
+// ply from the mates: a position whose opponent is lost after one of its moves wins one ply later, and a position
+// whose moves all lead to positions the opponent wins loses one ply after the last of them is found. Each step
+// only visits the positions found in the step before and their predecessors, found by taking moves back. The
+// positions left at the end are draws.
+//
+// A position is identified by side to move * size + index. Each step is shared out between the threads; the
+// values and counters they update are accessed atomically.
+class TablebaseGenerator {
+public:
+    TablebaseGenerator(const Tablebases& tables, const Material& material, int threads)
+        : tables(tables), layout(makeLayout(material)), threads(max(threads, 1)) {}
+
+    // False, with the reason written to the log, if a needed table is missing or a mate is too long to store
+    bool run(ostream& log);
+
+    const vector<uint8_t>& getValues() const { return values; }
+    uint64_t getSize() const { return layout.size; }
+
+private:
+    // What the moves of a position lead to
+    struct MoveSummary {
+        int legalMoves = 0;
+        uint32_t children[MaxMoves]; // Distinct positions in the table after the moves that stay in it
+        int childCount = 0;
+        int winPlies = -1;       // Shortest win through a move that leaves the table
+        int lossPlies = 0;       // Longest loss through the moves that leave the table
+        bool drawExit = false;   // A move that leaves the table draws
+        bool missingTable = false;
+    };
+
+    void initialize(uint64_t index, vector<vector<uint32_t>>& found);
+    void summarizeMoves(const int* squares, int side, MoveSummary& summary) const;
+    void exitMove(const int* squares, int side, int mover, int captured, Pieces promotion, MoveSummary& summary) const;
+    int predecessors(const int* squares, int side, uint32_t* positions) const;
+    void resolve(uint32_t position, int plies, vector<vector<uint32_t>>& found);
+
+    // Share the items out between the threads in chunks. Each thread collects the positions it finds per ply,
+    // which are added to the schedule afterwards.
+    template <typename Work>
+    void parallel(uint64_t items, Work work);
+
+    const Tablebases& tables;
+    Layout layout;
+    int threads;
+    vector<uint8_t> values;     // Plies to mate + 1, 0 while unknown and for draws
+    vector<uint8_t> counters;   // Positions in the table after the moves not known to lose yet
+    vector<uint8_t> exitLosses; // Plies of the longest loss through a move that leaves the table
+    vector<vector<uint32_t>> schedule; // Positions to resolve, per ply
+    atomic<bool> missingTable{ false };
+};
+
+template <typename Work>
+void TablebaseGenerator::parallel(uint64_t items, Work work) {
+    const uint64_t chunk = 4096;
+    atomic<uint64_t> next{ 0 };
+    vector<vector<vector<uint32_t>>> found(threads, vector<vector<uint32_t>>(MaxStoredPlies + 2));
+    runOnThreads(threads, [&](int worker) {
+        while (true) {
+            uint64_t start = next.fetch_add(chunk, memory_order_relaxed);
+            if (start >= items) {
+                break;
+            }
+            uint64_t end = min(start + chunk, items);
+            for (uint64_t item = start; item < end; item++) {
+                work(item, found[worker]);
+            }
+        }
+    });
+    for (const vector<vector<uint32_t>>& threadFound : found) {
+        for (int plies = 0; plies <= MaxStoredPlies + 1; plies++) {
+            schedule[plies].insert(schedule[plies].end(), threadFound[plies].begin(), threadFound[plies].end());
+        }
+    }
+}
+
+bool TablebaseGenerator::run(ostream& log) {
+    values.assign(2 * layout.size, 0);
+    counters.assign(2 * layout.size, 0);
+    exitLosses.assign(2 * layout.size, 0);
+    schedule.assign(MaxStoredPlies + 2, {});
+
+    parallel(layout.size, [this](uint64_t index, vector<vector<uint32_t>>& found) {
+        initialize(index, found);
+    });
+    if (missingTable) {
+        log << "A table needed to generate this one is not open" << endl;
+        return false;
+    }
+
+    for (int plies = 0; plies <= MaxStoredPlies; plies++) {
+        vector<uint32_t> current;
+        current.swap(schedule[plies]);
+        parallel(current.size(), [this, &current, plies](uint64_t item, vector<vector<uint32_t>>& found) {
+            resolve(current[item], plies, found);
+        });
+    }
+    for (uint32_t position : schedule[MaxStoredPlies + 1]) {
+        if (values[position] != 0) {
+            continue; // Settled before with a shorter mate
+        }
+        log << "A mate is longer than " << MaxStoredPlies << " plies, which the table format cannot store" << endl;
+        return false;
+    }
+    return true;
+}
+
+void TablebaseGenerator::initialize(uint64_t index, vector<vector<uint32_t>>& found) {
+    int squares[MaxTablebasePieces];
+    positionSquares(layout, index, squares);
+
+    // Only one index of each position is used; the others are left as draws and never read
+    if (positionIndex(layout, squares) != index) {
+        return;
+    }
+    Bitboard occupied = 0;
+    for (int i = 0; i < layout.count; i++) {
+        if (occupied & squareBit(squares[i])) {
+            return;
+        }
+        occupied |= squareBit(squares[i]);
+        if (layout.types[i] == Pieces::Pawn && (squares[i] / 8 == 0 || squares[i] / 8 == 7)) {
+            return;
+        }
+    }
+
+    for (int side = 0; side < 2; side++) {
+        // The side that just moved cannot be in check
+        if (isAttacked(layout, squares, squares[1 - side], side, occupied)) {
+            continue;
+        }
+        MoveSummary summary;
+        summarizeMoves(squares, side, summary);
+        if (summary.missingTable) {
+            missingTable = true;
+            return;
+        }
+
+        uint64_t position = side * layout.size + index;
+        if (summary.legalMoves == 0) {
+            // Checkmate is lost now; stalemate stays a draw
+            if (isAttacked(layout, squares, squares[side], 1 - side, occupied)) {
+                found[0].push_back(static_cast<uint32_t>(position));
+            }
+            continue;
+        }
+        int counter = summary.childCount;
+        if (summary.winPlies >= 0) {
+            found[min(summary.winPlies, MaxStoredPlies + 1)].push_back(static_cast<uint32_t>(position));
+            counter++; // Cannot be lost
+        }
+        if (summary.drawExit) {
+            counter++; // Cannot be lost
+        }
+        exitLosses[position] = static_cast<uint8_t>(min(summary.lossPlies, MaxStoredPlies + 1));
+        counters[position] = static_cast<uint8_t>(counter);
+        if (counter == 0) {
+            // Every move captures or promotes into a position the opponent wins
+            found[min(summary.lossPlies, MaxStoredPlies + 1)].push_back(static_cast<uint32_t>(position));
+        }
+    }
+}
+
+void TablebaseGenerator::summarizeMoves(const int* squares, int side, MoveSummary& summary) const {
+    Bitboard occupied = occupancy(layout, squares);
+    Bitboard own = occupancy(layout, squares, side);
+    Bitboard opponent = occupied & ~own;
+    int moved[MaxTablebasePieces];
+
+    for (int i = 0; i < layout.count; i++) {
+        if (layout.colors[i] != side) {
+            continue;
+        }
+        int from = squares[i];
+        Bitboard targets;
+        if (layout.types[i] == Pieces::Pawn) {
+            int forward = (side == 0) ? 8 : -8;
+            targets = PawnAttacks[side][from] & opponent;
+            if (!(occupied & squareBit(from + forward))) {
+                targets |= squareBit(from + forward);
+                int startRow = (side == 0) ? 1 : 6;
+                if (from / 8 == startRow && !(occupied & squareBit(from + 2 * forward))) {
+                    targets |= squareBit(from + 2 * forward);
+                }
+            }
+        }
+        else {
+            targets = pieceAttacks(layout.types[i], side, from, occupied) & ~own;
+        }
+
+        while (targets) {
+            int to = popLowestSquare(targets);
+            int captured = -1;
+            if (opponent & squareBit(to)) {
+                for (int j = 0; j < layout.count; j++) {
+                    if (squares[j] == to) {
+                        captured = j;
+                    }
+                }
+            }
+            copy(squares, squares + layout.count, moved);
+            moved[i] = to;
+            Bitboard after = (occupied & ~squareBit(from)) | squareBit(to);
+            if (isAttacked(layout, moved, moved[side], 1 - side, after, captured)) {
+                continue; // Leaves the own king in check
+            }
+
+            bool promotes = layout.types[i] == Pieces::Pawn && (to / 8 == 0 || to / 8 == 7);
+            if (promotes) {
+                for (int promotion = 0; promotion < 4; promotion++) {
+                    summary.legalMoves++;
+                    exitMove(moved, side, i, captured, NamedTypes[promotion], summary);
+                }
+            }
+            else if (captured >= 0) {
+                summary.legalMoves++;
+                exitMove(moved, side, i, captured, Pieces::None, summary);
+            }
+            else {
+                summary.legalMoves++;
+                uint32_t child = static_cast<uint32_t>((1 - side) * layout.size + positionIndex(layout, moved));
+                if (find(summary.children, summary.children + summary.childCount, child) == summary.children + summary.childCount) {
+                    summary.children[summary.childCount++] = child;
+                }
+            }
+        }
+    }
+}
+
+// Outcome of a move that leaves the table, read from the table of the material after it
+void TablebaseGenerator::exitMove(const int* squares, int side, int mover, int captured, Pieces promotion, MoveSummary& summary) const {
+    Tablebases::PieceList child;
+    for (int i = 0; i < layout.count; i++) {
+        if (i == captured) {
+            continue;
+        }
+        child.colors[child.count] = layout.colors[i];
+        child.types[child.count] = (i == mover && promotion != Pieces::None) ? promotion : layout.types[i];
+        child.squares[child.count] = squares[i];
+        child.count++;
+    }
+    child.sideToMove = 1 - side;
+
+    TablebaseResult result;
+    if (!tables.probePosition(child, result)) {
+        summary.missingTable = true;
+        return;
+    }
+    if (result.outcome == TablebaseOutcome::Loss) {
+        summary.winPlies = (summary.winPlies < 0) ? result.pliesToMate + 1 : min(summary.winPlies, result.pliesToMate + 1);
+    }
+    else if (result.outcome == TablebaseOutcome::Win) {
+        summary.lossPlies = max(summary.lossPlies, result.pliesToMate + 1);
+    }
+    else {
+        summary.drawExit = true;
+    }
+}
+
+// Positions of the table with the other side to move from which a move that neither captures nor promotes
+// leads to this one. Returns how many were stored, each once.
+int TablebaseGenerator::predecessors(const int* squares, int side, uint32_t* positions) const {
+    int mover = 1 - side;
+    Bitboard occupied = occupancy(layout, squares);
+    int before[MaxTablebasePieces];
+    int count = 0;
+
+    for (int i = 0; i < layout.count; i++) {
+        if (layout.colors[i] != mover) {
+            continue;
+        }
+        int to = squares[i];
+        Bitboard sources = 0;
+        if (layout.types[i] == Pieces::Pawn) {
+            int back = (mover == 0) ? -8 : 8;
+            int from = to + back;
+            if (from / 8 >= 1 && from / 8 <= 6 && !(occupied & squareBit(from))) {
+                sources |= squareBit(from);
+                int doublePushRow = (mover == 0) ? 3 : 4;
+                if (to / 8 == doublePushRow && !(occupied & squareBit(from + back))) {
+                    sources |= squareBit(from + back);
+                }
+            }
+        }
+        else {
+            sources = pieceAttacks(layout.types[i], mover, to, occupied) & ~occupied;
+        }
+
+        while (sources) {
+            int from = popLowestSquare(sources);
+            copy(squares, squares + layout.count, before);
+            before[i] = from;
+            // The side to move here cannot have been in check before the move
+            Bitboard previous = (occupied & ~squareBit(to)) | squareBit(from);
+            if (isAttacked(layout, before, before[side], mover, previous)) {
+                continue;
+            }
+            uint64_t index = positionIndex(layout, before);
+            if (index == InvalidIndex) {
+                continue;
+            }
+            uint32_t position = static_cast<uint32_t>(mover * layout.size + index);
+            if (find(positions, positions + count, position) == positions + count) {
+                positions[count++] = position;
+            }
+        }
+    }
+    return count;
+}
+
+// Settle a position found for this ply, and pass the news on to its predecessors
+void TablebaseGenerator::resolve(uint32_t position, int plies, vector<vector<uint32_t>>& found) {
+    uint8_t unknown = 0;
+    if (!atomic_ref<uint8_t>(values[position]).compare_exchange_strong(unknown, static_cast<uint8_t>(plies + 1))) {
+        return; // Found before, with a shorter win, or scheduled twice
+    }
+    int side = static_cast<int>(position / layout.size);
+    int squares[MaxTablebasePieces];
+    positionSquares(layout, position % layout.size, squares);
+
+    uint32_t previous[MaxMoves];
+    int count = predecessors(squares, side, previous);
+    bool lost = (plies % 2 == 0);
+    for (int i = 0; i < count; i++) {
+        uint32_t predecessor = previous[i];
+        if (atomic_ref<uint8_t>(values[predecessor]).load(memory_order_relaxed) != 0) {
+            continue;
+        }
+        if (lost) {
+            found[plies + 1].push_back(predecessor);
+        }
+        else if (atomic_ref<uint8_t>(counters[predecessor]).fetch_sub(1, memory_order_relaxed) == 1) {
+            // This was the last move of the predecessor that did not lose
+            found[min(max(plies + 1, static_cast<int>(exitLosses[predecessor])), MaxStoredPlies + 1)].push_back(predecessor);
+        }
+    }
+}
+
+Tablebases::Tablebases() = default;
+Tablebases::~Tablebases() = default;
+
+int Tablebases::open(const string& directory) {
+    int opened = 0;
+    error_code error;
+    for (const filesystem::directory_entry& entry : filesystem::directory_iterator(directory, error)) {
+        if (entry.path().extension() == ".cgtb" && openFile(entry.path().string())) {
+            opened++;
+        }
+    }
+    return opened;
+}
+
+bool Tablebases::openFile(const string& path) {
+    unique_ptr<Table> table = make_unique<Table>();
+    if (!table->file.open(path.c_str())) {
+        return false;
+    }
+    string_view text = table->file.text();
+    FileHeader header;
+    if (text.size() < sizeof(header)) {
+        return false;
+    }
+    memcpy(&header, text.data(), sizeof(header));
+    Material material;
+    string name(header.material, strnlen(header.material, sizeof(header.material)));
+    if (memcmp(header.magic, FileMagic, sizeof(FileMagic)) != 0 || header.version != FileVersion
+        || !parseMaterial(name, material) || canonicalMaterial(material).key() != material.key()) {
+        return false;
+    }
+    table->layout = makeLayout(material);
+    if (header.positions != table->layout.size || text.size() != sizeof(header) + 2 * table->layout.size) {
+        return false;
+    }
+    table->values = reinterpret_cast<const uint8_t*>(text.data() + sizeof(header));
+    tables[material.key()] = move(table);
+    return true;
+}
+
+bool Tablebases::probe(const Board& board, TablebaseResult& result) const {
+    // Positions where the side not to move is in check are left out of the tables, so they have no value
+    if (board.getCastlingRights() != 0 || board.getEnPassantSquare() >= 0
+        || popCount(board.getOccupied()) > MaxTablebasePieces || board.isInCheck(oppositeColor(board.getSideToMove()))) {
+        return false;
+    }
+    PieceList position;
+    for (Colors side : { Colors::White, Colors::Black }) {
+        for (int type = static_cast<int>(Pieces::Pawn); type <= static_cast<int>(Pieces::King); type++) {
+            Bitboard pieces = board.getPieces(side, static_cast<Pieces>(type));
+            while (pieces) {
+                position.colors[position.count] = colorIndex(side);
+                position.types[position.count] = static_cast<Pieces>(type);
+                position.squares[position.count] = popLowestSquare(pieces);
+                position.count++;
+            }
+        }
+    }
+    position.sideToMove = colorIndex(board.getSideToMove());
+    return probePosition(position, result);
+}
+
+bool Tablebases::probePosition(PieceList position, TablebaseResult& result) const {
+    Material material;
+    for (int i = 0; i < position.count; i++) {
+        if (position.types[i] != Pieces::King) {
+            material.count[position.colors[i]][static_cast<int>(position.types[i])]++;
+        }
+    }
+    if (material.pieces() == 0) {
+        result = TablebaseResult();
+        return true;
+    }
+
+    // A table of the same material with the colors swapped: swap them in the position, and turn the board
+    // round so that pawns still move the right way
+    auto found = tables.find(material.key());
+    if (found == tables.end()) {
+        found = tables.find(material.flipped().key());
+        if (found == tables.end()) {
+            return false;
+        }
+        for (int i = 0; i < position.count; i++) {
+            position.colors[i] = 1 - position.colors[i];
+            position.squares[i] ^= 56;
+        }
+        position.sideToMove = 1 - position.sideToMove;
+    }
+
+    // Put the squares in the order of the table's layout
+    const Table& table = *found->second;
+    int squares[MaxTablebasePieces];
+    bool used[MaxTablebasePieces] = {};
+    for (int slot = 0; slot < table.layout.count; slot++) {
+        for (int i = 0; i < position.count; i++) {
+            if (!used[i] && position.colors[i] == table.layout.colors[slot] && position.types[i] == table.layout.types[slot]) {
+                used[i] = true;
+                squares[slot] = position.squares[i];
+                break;
+            }
+        }
+    }
+    uint64_t index = positionIndex(table.layout, squares);
+    if (index == InvalidIndex) {
+        return false;
+    }
+    decodeValue(table.values[position.sideToMove * table.layout.size + index], result);
+    return true;
+}
+
+bool Tablebases::generate(string_view name, const string& directory, int threads, ostream& log) {
+    Material material;
+    if (!parseMaterial(name, material)) {
+        log << "Invalid material " << name << ": expected a name such as KRvK, with at most "
+            << MaxTablebasePieces << " pieces" << endl;
+        return false;
+    }
+    material = canonicalMaterial(material);
+    if (material.pieces() == 0 || tables.count(material.key()) > 0) {
+        return true;
+    }
+    for (const Material& child : childMaterials(material)) {
+        if (!generate(child.name(), directory, threads, log)) {
+            return false;
+        }
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    TablebaseGenerator generator(*this, material, threads);
+    log << material.name() << ": ";
+    if (!generator.run(log)) {
+        return false;
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    FileHeader header = {};
+    memcpy(header.magic, FileMagic, sizeof(FileMagic));
+    header.version = FileVersion;
+    string tableName = material.name();
+    memcpy(header.material, tableName.data(), tableName.size());
+    header.positions = generator.getSize();
+    string path = (filesystem::path(directory) / (tableName + ".cgtb")).string();
+    {
+        ofstream file(path, ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(generator.getValues().data()), static_cast<streamsize>(generator.getValues().size()));
+        if (!file) {
+            log << "cannot write " << path << endl;
+            return false;
+        }
+    }
+    if (!openFile(path)) {
+        log << "cannot open " << path << " after writing it" << endl;
+        return false;
+    }
+
+    // Summary: how the positions with White to move end, and the longest mate
+    const vector<uint8_t>& values = generator.getValues();
+    uint64_t wins = 0, losses = 0;
+    int longest = 0;
+    for (uint64_t index = 0; index < generator.getSize(); index++) {
+        if (values[index] != 0 && (values[index] - 1) % 2 != 0) {
+            wins++;
+        }
+        else if (values[index] != 0) {
+            losses++;
+        }
+        longest = max(longest, values[index] - 1);
+        longest = max(longest, values[generator.getSize() + index] - 1);
+    }
+    log << generator.getSize() << " positions per side, White to move wins " << wins << " and loses " << losses
+        << ", longest mate " << longest << " plies, " << seconds << " s" << endl;
+    return true;
+}
@@ -0,0 +1,71 @@
+/*
+ * File: Tablebase.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the endgame tablebases: their retrograde generator and the memory-mapped
+ *              probe.
+ */
+
+#pragma once
+
+#include "Classes.h"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// An endgame tablebase holds, for every position of one material set with both sides to move, whether the side
+// to move wins, draws or loses with best play, and in how many plies the winner mates (the distance to mate).
+//
+// Tables are named after their material, stronger side first, such as "KQvK" or "KRvKN", and each is stored in
+// its own file "<name>.cgtb": a short header followed by one byte per position, first with White to move and
+// then with Black to move. A position's place in the file is computed from the squares of its pieces, so
+// probing is a few table lookups and one read of the mapped file. The board's symmetries are used to store
+// each position once: all eight for tables without pawns, the left-right mirror for tables with pawns.
+//
+// Positions are taken without castling rights and without en passant captures.
+const int MaxTablebasePieces = 5;
+
+enum class TablebaseOutcome { Loss, Draw, Win };
+
+// Outcome of a position for the side to move
+struct TablebaseResult {
+    TablebaseOutcome outcome = TablebaseOutcome::Draw;
+    int pliesToMate = 0; // Plies until the winning side mates, with best play from both sides. 0 for draws.
+};
+
+class Tablebases {
+public:
+    Tablebases();
+    ~Tablebases();
+    Tablebases(const Tablebases&) = delete;
+    Tablebases& operator=(const Tablebases&) = delete;
+
+    // Map every table file of the directory. Returns the number of tables opened.
+    int open(const string& directory);
+
+    // Look up the position of the board. False if no open table has its material, it has castling rights or
+    // an en passant square, or the side not to move is in check. Positions with only the two kings are draws
+    // without a table.
+    bool probe(const Board& board, TablebaseResult& result) const;
+
+    // Generate the table of a material, such as "KRvK", on the given number of threads. The tables of the
+    // materials it can turn into by a capture or a promotion are needed to generate it; those not open yet are
+    // generated first. Each generated table is written to the directory and opened. Returns false, with the
+    // reason written to the log, if the material is not valid or a table cannot be written.
+    bool generate(string_view material, const string& directory, int threads, ostream& log);
+
+    size_t tableCount() const { return tables.size(); }
+
+private:
+    struct Table;
+    struct PieceList;
+    friend class TablebaseGenerator;
+
+    bool openFile(const string& path);
+    bool probePosition(PieceList position, TablebaseResult& result) const;
+
+    unordered_map<uint64_t, unique_ptr<Table>> tables; // Keyed by material
+};
@@ -0,0 +1,84 @@
+/*
+ * File: Trace.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the move tracing facility.
+ */
+
+#include "Trace.h"
+
+#ifdef CHESS_TRACE
+
+#include <atomic>
+#include <fstream>
+
+namespace {
+    const char* const EventNames[] = { "validate", "check-scan", "check-found", "simulate" };
+    const char* const PieceNames[] = { "-", "Pawn", "Knight", "Bishop", "Rook", "Queen", "King" };
+
+    // Power of two, so the write position wraps with a mask
+    const uint32_t TraceCapacity = 1 << 16;
+
+    // Records are stored packed into one 32-bit word each, so threads tracing at once write whole records
+    // atomically: event, piece type, start square and end square from the lowest byte up
+    uint32_t packRecord(const TraceRecord& record) {
+        return static_cast<uint32_t>(record.event) | (static_cast<uint32_t>(record.pieceType) << 8)
+            | (static_cast<uint32_t>(record.from) << 16) | (static_cast<uint32_t>(record.to) << 24);
+    }
+
+    TraceRecord unpackRecord(uint32_t word) {
+        return { static_cast<TraceEvent>(word & 0xFF), static_cast<uint8_t>(word >> 8),
+            static_cast<uint8_t>(word >> 16), static_cast<uint8_t>(word >> 24) };
+    }
+
+    class TraceLog {
+    public:
+        std::atomic<uint32_t> records[TraceCapacity] = {};
+        std::atomic<uint64_t> written{ 0 };
+        std::atomic<uint64_t> eventCounts[static_cast<int>(TraceEvent::EventCount)] = {};
+        std::atomic<uint64_t> validationsPerPiece[7] = {};
+
+        // Write the counters and the buffered events when the program ends
+        ~TraceLog() {
+            std::ofstream file("chess_trace.log");
+            if (!file) {
+                return;
+            }
+            file << "Counters" << std::endl;
+            for (int event = 0; event < static_cast<int>(TraceEvent::EventCount); event++) {
+                file << "  " << EventNames[event] << ": " << eventCounts[event] << std::endl;
+            }
+            for (int type = 1; type < 7; type++) {
+                file << "  validate " << PieceNames[type] << ": " << validationsPerPiece[type] << std::endl;
+            }
+
+            uint64_t total = written;
+            uint64_t first = (total > TraceCapacity) ? total - TraceCapacity : 0;
+            file << "Last " << total - first << " of " << total << " events" << std::endl;
+            for (uint64_t i = first; i < total; i++) {
+                TraceRecord record = unpackRecord(records[i & (TraceCapacity - 1)].load(std::memory_order_relaxed));
+                file << EventNames[static_cast<int>(record.event)] << " " << PieceNames[record.pieceType];
+                for (uint8_t square : { record.from, record.to }) {
+                    if (square != NoTraceSquare) {
+                        file << " " << static_cast<char>('a' + square % 8) << static_cast<char>('1' + square / 8);
+                    }
+                }
+                file << '\n';
+            }
+        }
+    };
+
+    TraceLog traceLog;
+}
+
+void traceEvent(TraceEvent event, int pieceType, int from, int to) {
+    traceLog.eventCounts[static_cast<int>(event)].fetch_add(1, std::memory_order_relaxed);
+    if (event == TraceEvent::Validation) {
+        traceLog.validationsPerPiece[pieceType].fetch_add(1, std::memory_order_relaxed);
+    }
+    uint64_t index = traceLog.written.fetch_add(1, std::memory_order_relaxed);
+    traceLog.records[index & (TraceCapacity - 1)].store(packRecord({ event, static_cast<uint8_t>(pieceType),
+        static_cast<uint8_t>(from), static_cast<uint8_t>(to) }), std::memory_order_relaxed);
+}
+
+#endif
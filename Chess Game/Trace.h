@@ -0,0 +1,44 @@
+/*
+ * File: Trace.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the move tracing facility. Tracing is compiled in only when
+ *              CHESS_TRACE is defined; otherwise the TRACE_EVENT macro expands to nothing.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// What happened. Each event also carries a piece type (as in Pieces) and up to two squares.
+enum class TraceEvent : uint8_t {
+    Validation, // A piece's isValidMove was called: piece, start square, end square
+    CheckScan,  // A king was tested for check: King, king square
+    CheckFound, // The test found an attacker: attacking piece, its square, king square
+    Simulation, // A move was tried on the board to see if it leaves the own king in check: moving piece, start, end
+    EventCount
+};
+
+// One recorded event. Squares are indexes (row * 8 + col), NoTraceSquare when not used.
+struct TraceRecord {
+    TraceEvent event;
+    uint8_t pieceType;
+    uint8_t from;
+    uint8_t to;
+};
+
+const uint8_t NoTraceSquare = 0xFF;
+
+#ifdef CHESS_TRACE
+
+// Count the event and store it in the in-memory trace buffer. The buffer keeps the most recent events and is
+// written to chess_trace.log, with the counters, when the program exits.
+void traceEvent(TraceEvent event, int pieceType, int from, int to);
+
+#define TRACE_EVENT(event, pieceType, from, to) traceEvent((event), static_cast<int>(pieceType), (from), (to))
+
+#else
+
+#define TRACE_EVENT(event, pieceType, from, to) ((void)0)
+
+#endif
@@ -0,0 +1,145 @@
+/*
+ * File: TranspositionTable.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Implementation of the lockless transposition table.
+ */
+
+#include "TranspositionTable.h"
+
+namespace {
+    // Layout of the data word of an entry:
+    //   bits  0-31  move (from, to, promotion, flags)
+    //   bits 32-47  score
+    //   bits 48-55  depth
+    //   bits 56-57  bound
+    //   bits 58-63  generation of the search that stored it
+    uint64_t packEntry(const TTEntry& entry, uint8_t generation) {
+        uint64_t move = entry.move.from | (entry.move.to << 8) | (static_cast<uint32_t>(entry.move.promotion) << 16)
+            | (static_cast<uint32_t>(entry.move.flags) << 24);
+        return move
+            | (static_cast<uint64_t>(static_cast<uint16_t>(entry.score)) << 32)
+            | (static_cast<uint64_t>(static_cast<uint8_t>(entry.depth)) << 48)
+            | (static_cast<uint64_t>(entry.bound) << 56)
+            | (static_cast<uint64_t>(generation) << 58);
+    }
+
+    TTEntry unpackEntry(uint64_t data) {
+        TTEntry entry;
+        entry.move.from = static_cast<uint8_t>(data);
+        entry.move.to = static_cast<uint8_t>(data >> 8);
+        entry.move.promotion = static_cast<Pieces>((data >> 16) & 0xFF);
+        entry.move.flags = static_cast<uint8_t>(data >> 24);
+        entry.score = static_cast<int16_t>(data >> 32);
+        entry.depth = static_cast<uint8_t>(data >> 48);
+        entry.bound = static_cast<Bound>((data >> 56) & 3);
+        return entry;
+    }
+
+    uint8_t entryGeneration(uint64_t data) {
+        return static_cast<uint8_t>(data >> 58);
+    }
+
+    int entryDepth(uint64_t data) {
+        return static_cast<uint8_t>(data >> 48);
+    }
+
+    bool isEmpty(uint64_t data) {
+        return static_cast<Bound>((data >> 56) & 3) == Bound::None;
+    }
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes) {
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes) {
+    size_t wanted = megabytes * 1024 * 1024 / sizeof(Bucket);
+    bucketCount = 1;
+    while (bucketCount * 2 <= wanted) {
+        bucketCount *= 2;
+    }
+    buckets.reset(new Bucket[bucketCount]);
+    generation = 0;
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i < bucketCount; i++) {
+        for (Entry& slot : buckets[i].entries) {
+            slot.keyXorData.store(0, std::memory_order_relaxed);
+            slot.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+// Look up the position. Returns false if it is not in the table, or its entry was torn by a concurrent store.
+bool TranspositionTable::probe(uint64_t key, TTEntry& entry) const {
+    const Bucket& bucket = bucketOf(key);
+    for (const Entry& slot : bucket.entries) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+        if ((keyXorData ^ data) == key && !isEmpty(data)) {
+            entry = unpackEntry(data);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Store the entry in the slot already holding this position if there is one. Otherwise take an empty
+// slot, or replace the least useful one: the shallowest, with entries from older searches counting as
+// shallower the older they are.
+TTStore TranspositionTable::store(uint64_t key, const TTEntry& entry) {
+    Bucket& bucket = bucketOf(key);
+    Entry* target = nullptr;
+    int targetWorth = 0;
+    TTStore result = TTStore::Replaced;
+    TTEntry stored = entry;
+
+    for (Entry& slot : bucket.entries) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t keyXorData = slot.keyXorData.load(std::memory_order_relaxed);
+        if (isEmpty(data)) {
+            if (result == TTStore::Replaced) {
+                target = &slot;
+                result = TTStore::NewEntry;
+            }
+            continue;
+        }
+        if ((keyXorData ^ data) == key) {
+            // Keep the best move found earlier if this search did not find one
+            if (stored.move.from == stored.move.to) {
+                stored.move = unpackEntry(data).move;
+            }
+            target = &slot;
+            result = TTStore::SamePosition;
+            break;
+        }
+        if (result == TTStore::Replaced) {
+            int age = (generation - entryGeneration(data)) & GenerationMask;
+            int worth = entryDepth(data) - 8 * age;
+            if (target == nullptr || worth < targetWorth) {
+                target = &slot;
+                targetWorth = worth;
+            }
+        }
+    }
+
+    uint64_t data = packEntry(stored, generation);
+    target->data.store(data, std::memory_order_relaxed);
+    target->keyXorData.store(key ^ data, std::memory_order_relaxed);
+    return result;
+}
+
+int TranspositionTable::permilleFull() const {
+    size_t sampled = (bucketCount < 250) ? bucketCount : 250;
+    int used = 0;
+    for (size_t i = 0; i < sampled; i++) {
+        for (const Entry& slot : buckets[i].entries) {
+            uint64_t data = slot.data.load(std::memory_order_relaxed);
+            used += !isEmpty(data) && entryGeneration(data) == generation;
+        }
+    }
+    return static_cast<int>(used * 1000 / (sampled * BucketEntries));
+}
@@ -0,0 +1,91 @@
+/*
+ * File: TranspositionTable.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the transposition table shared by the search threads.
+ */
+
+#pragma once
+
+#include "Classes.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// How a stored score relates to the true score of the position
+enum class Bound : uint8_t { None, Exact, Lower, Upper };
+
+// What the table knows about a position
+struct TTEntry {
+    Move move = {};   // Best move found, from == to when there is none
+    int score = 0;
+    int depth = 0;
+    Bound bound = Bound::None;
+};
+
+// What a store did to the table
+enum class TTStore { NewEntry, SamePosition, Replaced };
+
+// Fixed-size hash table of search results keyed by the Zobrist key of the position.
+//
+// Entries are grouped in buckets of four that fill one 64-byte cache line, so a probe touches a single line.
+// Each entry is two 64-bit words, the packed data and the key XORed with the data, written and read
+// without locks. A probe only accepts an entry when key ^ data gives back the key it looked for, so an
+// entry torn by two threads writing it at once reads as a miss instead of as wrong data.
+class TranspositionTable {
+public:
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    // Reallocate to the largest power of two number of buckets that fits in the given size, and clear it
+    void resize(size_t megabytes);
+    void clear();
+    size_t sizeInBytes() const { return bucketCount * sizeof(Bucket); }
+
+    // Start of a new search: entries from older searches are replaced first
+    void newSearch() { generation = (generation + 1) & GenerationMask; }
+
+    bool probe(uint64_t key, TTEntry& entry) const;
+    TTStore store(uint64_t key, const TTEntry& entry);
+
+    // Parts per thousand of a sample of the table used by the current search
+    int permilleFull() const;
+
+private:
+    static const int BucketEntries = 4;
+    static const uint8_t GenerationMask = 0x3F;
+
+    struct Entry {
+        std::atomic<uint64_t> keyXorData{ 0 };
+        std::atomic<uint64_t> data{ 0 };
+    };
+    struct alignas(64) Bucket {
+        Entry entries[BucketEntries];
+    };
+
+    Bucket& bucketOf(uint64_t key) const { return buckets[key & (bucketCount - 1)]; }
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount = 0;
+    uint8_t generation = 0;
+};
+
+// Search statistics of the table, counted by each search thread for itself
+struct TTStats {
+    uint64_t probes = 0;
+    uint64_t hits = 0;
+    uint64_t cutoffs = 0;      // Probes whose score ended the search of the node
+    uint64_t stores = 0;
+    uint64_t replacements = 0; // Stores that overwrote a different position
+
+    double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0; }
+
+    TTStats& operator+=(const TTStats& other) {
+        probes += other.probes;
+        hits += other.hits;
+        cutoffs += other.cutoffs;
+        stores += other.stores;
+        replacements += other.replacements;
+        return *this;
+    }
+};
@@ -0,0 +1,40 @@
+/*
+ * File: Zobrist.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Generation of the random keys used to hash board positions.
+ */
+
+#include "Zobrist.h"
+
+namespace {
+    // SplitMix64: small, good quality generator. Fixed seed so keys are the same in every run and build.
+    constexpr uint64_t nextRandom(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr ZobristKeys generateKeys() {
+        ZobristKeys keys{};
+        uint64_t state = 0x436865636B6D6174ULL;
+        for (int color = 0; color < 2; color++) {
+            for (int type = 0; type < 7; type++) {
+                for (int square = 0; square < 64; square++) {
+                    keys.pieceSquare[color][type][square] = nextRandom(state);
+                }
+            }
+        }
+        keys.blackToMove = nextRandom(state);
+        for (int rights = 0; rights < 16; rights++) {
+            keys.castling[rights] = nextRandom(state);
+        }
+        for (int file = 0; file < 8; file++) {
+            keys.enPassantFile[file] = nextRandom(state);
+        }
+        return keys;
+    }
+}
+
+const ZobristKeys Zobrist = generateKeys();
@@ -0,0 +1,22 @@
+/*
+ * File: Zobrist.h
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Header file containing the random keys used to hash board positions.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// A position's key is the XOR of one key per piece on its square, plus the keys of the side to move,
+// the castling rights and the en passant file. Moving a piece changes the key by two XORs.
+struct ZobristKeys {
+    uint64_t pieceSquare[2][7][64]; // [color index][piece type][square]
+    uint64_t blackToMove;
+    uint64_t castling[16];          // One key per combination of castling rights
+    uint64_t enPassantFile[8];
+};
+
+extern const ZobristKeys Zobrist;
@@ -0,0 +1,282 @@
+/*
+ * File: Validator.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: PGN validator - replays every game of a PGN file, checking that each move is legal, and
+ *              reports how each game ended. Games are checked on several threads while the file is streamed.
+ */
+
+#include "Classes.h"
+#include "MappedFile.h"
+#include "PGN.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Games read ahead of the oldest game whose report is not written yet, per thread. This bounds the memory
+// used whatever the size of the file.
+const int GamesInFlightPerThread = 64;
+
+const char* gameEndName(GameEnd end) {
+    switch (end) {
+    case GameEnd::Checkmate: return "checkmate";
+    case GameEnd::Stalemate: return "stalemate";
+    case GameEnd::FiftyMoveRule: return "50-move";
+    case GameEnd::ThreefoldRepetition: return "repetition";
+    case GameEnd::InsufficientMaterial: return "insufficient-material";
+    default: return "none";
+    }
+}
+
+// The outcome of checking one game
+struct Validation {
+    long long number = 0;
+    string result;               // Result the position on the board decides, or the one the game gives
+    GameEnd end = GameEnd::None; // How the final position ends the game
+    bool legal = true;
+    string illegalMove;          // First illegal move with its move number, e.g. "23... Nf3"
+    int plies = 0;               // Moves replayed
+};
+
+// Replay the game on the board and judge its final position
+Validation validateGame(const PGNGame& game, Board& board) {
+    Validation validation;
+    validation.number = game.number;
+    validation.result = game.result;
+
+    if (!board.fromFEN(game.fen.empty() ? StartFEN : game.fen)) {
+        validation.legal = false;
+        validation.illegalMove = "FEN";
+        return validation;
+    }
+
+    PGNTokenizer tokenizer(game.movetext);
+    string_view marker;
+    for (PGNToken token = tokenizer.next(); token.type != PGNTokenType::End; token = tokenizer.next()) {
+        if (token.type == PGNTokenType::Result) {
+            marker = token.text;
+            break;
+        }
+        if (token.type != PGNTokenType::Move || tokenizer.inVariation()) {
+            continue;
+        }
+        Move move;
+        if (!parseSAN(board, token.text, move)) {
+            validation.legal = false;
+            validation.illegalMove = to_string(board.getFullMoveNumber())
+                + (board.getSideToMove() == Colors::White ? ". " : "... ") + string(token.text);
+            return validation;
+        }
+        board.makeMove(move);
+        validation.plies++;
+    }
+
+    if (validation.result == "*" && !marker.empty()) {
+        validation.result = string(marker);
+    }
+
+    // Checkmate and the automatic draws decide the result, whatever the game says
+    validation.end = board.getGameEnd();
+    if (validation.end == GameEnd::Checkmate) {
+        validation.result = (board.getSideToMove() == Colors::White) ? "0-1" : "1-0";
+    }
+    else if (validation.end != GameEnd::None) {
+        validation.result = "1/2-1/2";
+    }
+    return validation;
+}
+
+// One line per game: number, result, how the game ended, and the first illegal move if there is one
+void printValidation(const Validation& validation) {
+    cout << validation.number << ' ' << validation.result << ' ';
+    if (validation.legal) {
+        cout << gameEndName(validation.end) << '\n';
+    }
+    else {
+        cout << "illegal " << validation.illegalMove << '\n';
+    }
+}
+
+// Games waiting to be checked, and checked games waiting for the reports of the games before them, so the
+// reports come out in file order
+struct ValidationQueue {
+    mutex lock;
+    condition_variable gameReady;
+    condition_variable roomReady;
+    deque<PGNGame> games;
+    map<long long, Validation> finished;
+    long long nextToReport = 1;
+    bool endOfFile = false;
+
+    // Totals for the summary
+    long long legalGames = 0;
+    long long plies = 0;
+    long long gameEnds[6] = {};
+};
+
+void worker(ValidationQueue& queue) {
+    Board board;
+    while (true) {
+        PGNGame game;
+        {
+            unique_lock<mutex> guard(queue.lock);
+            queue.gameReady.wait(guard, [&queue]() { return !queue.games.empty() || queue.endOfFile; });
+            if (queue.games.empty()) {
+                return;
+            }
+            game = move(queue.games.front());
+            queue.games.pop_front();
+        }
+
+        Validation validation = validateGame(game, board);
+
+        lock_guard<mutex> guard(queue.lock);
+        queue.finished.emplace(validation.number, move(validation));
+        bool reported = false;
+        for (auto next = queue.finished.begin(); next != queue.finished.end() && next->first == queue.nextToReport;
+            next = queue.finished.erase(next)) {
+            const Validation& done = next->second;
+            printValidation(done);
+            queue.legalGames += done.legal;
+            queue.plies += done.plies;
+            if (done.legal) {
+                queue.gameEnds[static_cast<int>(done.end)]++;
+            }
+            queue.nextToReport++;
+            reported = true;
+        }
+        if (reported) {
+            queue.roomReady.notify_one();
+        }
+    }
+}
+
+// Map the whole file and tokenize it, first only splitting it into tokens and then also replaying every move
+// of every game, and report the throughput of both
+int measureParsing(const char* path) {
+    MappedFile file;
+    if (!file.open(path)) {
+        cout << "Cannot map " << path << endl;
+        return 1;
+    }
+    string_view text = file.text();
+    double megabytes = text.size() / 1e6;
+
+    auto startTime = chrono::steady_clock::now();
+    long long tokens = 0, moves = 0;
+    PGNTokenizer tokenizer(text);
+    for (PGNToken token = tokenizer.next(); token.type != PGNTokenType::End; token = tokenizer.next()) {
+        tokens++;
+        moves += (token.type == PGNTokenType::Move && !tokenizer.inVariation());
+    }
+    double tokenizeSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    // A tag after the end of a game starts the next one
+    startTime = chrono::steady_clock::now();
+    Board board;
+    bool gameOver = false, skipGame = false;
+    long long games = 1, replayed = 0;
+    PGNTokenizer replayTokenizer(text);
+    for (PGNToken token = replayTokenizer.next(); token.type != PGNTokenType::End; token = replayTokenizer.next()) {
+        if (gameOver && (token.type == PGNTokenType::Tag || token.type == PGNTokenType::Move)) {
+            board.fromFEN(StartFEN);
+            gameOver = skipGame = false;
+            games++;
+        }
+        if (token.type == PGNTokenType::Result) {
+            gameOver = true;
+        }
+        else if (token.type == PGNTokenType::Tag && token.text == "FEN") {
+            skipGame = !board.fromFEN(token.value);
+        }
+        else if (token.type == PGNTokenType::Move && !replayTokenizer.inVariation() && !skipGame) {
+            Move move;
+            if (parseSAN(board, token.text, move)) {
+                board.makeMove(move);
+                replayed++;
+            }
+            else {
+                skipGame = true; // The rest of the game cannot be replayed
+            }
+        }
+    }
+    double replaySeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    cout << "File: " << megabytes << " MB, " << games << " games, " << tokens << " tokens, " << moves << " moves" << endl;
+    cout << "Tokenize:        " << megabytes / tokenizeSeconds << " MB/s, " << static_cast<long long>(moves / tokenizeSeconds)
+        << " moves/s" << endl;
+    cout << "Tokenize + SAN:  " << megabytes / replaySeconds << " MB/s, " << static_cast<long long>(replayed / replaySeconds)
+        << " moves/s (" << replayed << " moves replayed)" << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: PGNValidator <file.pgn> [threads <n> | parse]" << endl;
+        cout << "  Prints one line per game: <number> <result> <termination>, or <number> <result> illegal <move>" << endl;
+        cout << "  termination is checkmate, stalemate, 50-move, repetition, insufficient-material or none" << endl;
+        cout << "  threads  check games on this many threads (default: one per core)" << endl;
+        cout << "  parse    only measure how fast the memory-mapped file is tokenized and its moves replayed" << endl;
+        return 1;
+    }
+    if (argc >= 3 && string(argv[2]) == "parse") {
+        return measureParsing(argv[1]);
+    }
+
+    int threads = max(static_cast<int>(thread::hardware_concurrency()), 1);
+    if (argc >= 4 && string(argv[2]) == "threads") {
+        threads = max(atoi(argv[3]), 1);
+    }
+    ifstream file(argv[1], ios::binary);
+    if (!file) {
+        cout << "Cannot open " << argv[1] << endl;
+        return 1;
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    ValidationQueue queue;
+    vector<thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.emplace_back(worker, ref(queue));
+    }
+
+    // Stream the file, waiting whenever too many games are read ahead of the reports
+    const long long maxInFlight = static_cast<long long>(GamesInFlightPerThread) * threads;
+    PGNGame game;
+    while (readPGNGame(file, game)) {
+        unique_lock<mutex> guard(queue.lock);
+        queue.roomReady.wait(guard, [&queue, &game, maxInFlight]() { return game.number - queue.nextToReport < maxInFlight; });
+        queue.games.push_back(game);
+        queue.gameReady.notify_one();
+    }
+    {
+        lock_guard<mutex> guard(queue.lock);
+        queue.endOfFile = true;
+    }
+    queue.gameReady.notify_all();
+    for (thread& running : workers) {
+        running.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+    // Summary, on the error stream so the report stays one line per game
+    long long games = game.number;
+    cerr << "Games: " << games << " (" << queue.legalGames << " legal, " << games - queue.legalGames << " with an illegal move)" << endl;
+    for (int end = static_cast<int>(GameEnd::Checkmate); end <= static_cast<int>(GameEnd::InsufficientMaterial); end++) {
+        cerr << "  " << gameEndName(static_cast<GameEnd>(end)) << ": " << queue.gameEnds[end] << endl;
+    }
+    cerr << "Threads: " << threads << endl;
+    cerr << "Time: " << seconds << " s" << endl;
+    cerr << "Games/second: " << static_cast<long long>(seconds > 0 ? games / seconds : 0)
+        << ", moves/second: " << static_cast<long long>(seconds > 0 ? queue.plies / seconds : 0) << endl;
+    return 0;
+}
@@ -0,0 +1,416 @@
+/*
+ * File: Perft.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Perft tool - counts the leaf nodes of the legal move tree to a given depth, to measure
+ *              the speed and check the correctness of the move generator.
+ */
+
+#include "Classes.h"
+#include "ChessPieces.h"
+#include "Helpers.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Node counts of positions already counted, keyed by the Zobrist key of the position and the depth, shared by
+// all threads. Each slot holds the count and the key XORed with the count, written and read without locks:
+// a slot torn by two threads writing it at once does not verify and reads as a miss.
+class PerftCache {
+private:
+    struct Slot {
+        atomic<uint64_t> keyXorNodes{ 0 };
+        atomic<uint64_t> nodes{ 0 };
+    };
+    unique_ptr<Slot[]> slots;
+    size_t slotCount = 0;
+
+    // The same position at another depth has another count, so the depth is mixed into the key
+    static uint64_t slotKey(uint64_t hashKey, int depth) {
+        return hashKey ^ (0x9E3779B97F4A7C15ULL * static_cast<uint64_t>(depth));
+    }
+
+public:
+    explicit PerftCache(size_t megabytes) {
+        size_t wanted = megabytes * 1024 * 1024 / sizeof(Slot);
+        slotCount = 1;
+        while (slotCount * 2 <= wanted) {
+            slotCount *= 2;
+        }
+        slots.reset(new Slot[slotCount]);
+    }
+
+    bool probe(uint64_t hashKey, int depth, long long& nodes) const {
+        uint64_t key = slotKey(hashKey, depth);
+        const Slot& slot = slots[key & (slotCount - 1)];
+        uint64_t count = slot.nodes.load(memory_order_relaxed);
+        if ((slot.keyXorNodes.load(memory_order_relaxed) ^ count) != key || count == 0) {
+            return false;
+        }
+        nodes = static_cast<long long>(count);
+        return true;
+    }
+
+    void store(uint64_t hashKey, int depth, long long nodes) {
+        uint64_t key = slotKey(hashKey, depth);
+        Slot& slot = slots[key & (slotCount - 1)];
+        slot.nodes.store(static_cast<uint64_t>(nodes), memory_order_relaxed);
+        slot.keyXorNodes.store(key ^ static_cast<uint64_t>(nodes), memory_order_relaxed);
+    }
+};
+
+// Count the leaf nodes below the position. The last ply is counted from the size of the move list.
+// Subtrees of two plies or more are looked up in and stored to the cache, if there is one.
+long long perft(Board& board, Colors sideToMove, int depth, PerftCache* cache = nullptr) {
+    long long nodes = 0;
+    if (cache && depth > 1 && cache->probe(board.getHashKey(), depth, nodes)) {
+        return nodes;
+    }
+
+    MoveList moves = board.generateLegalMoves(sideToMove);
+    if (depth <= 1) {
+        return moves.count;
+    }
+
+    for (const Move& move : moves) {
+        board.makeMove(move);
+        nodes += perft(board, oppositeColor(sideToMove), depth - 1, cache);
+        board.unmakeMove();
+    }
+    if (cache) {
+        cache->store(board.getHashKey(), depth, nodes);
+    }
+    return nodes;
+}
+
+// The same count with every move checked by the piece's isValidMove, and the moves of interior nodes played
+// through movePiece, so that the validation path is timed and cross-checked against the generator. Each legal
+// move the piece's own rules reject is counted in failures; the count goes on with the generated move.
+long long perftValidated(Board& board, Colors sideToMove, int depth, long long& failures) {
+    MoveList moves = board.generateLegalMoves(sideToMove);
+    long long nodes = 0;
+    for (const Move& move : moves) {
+        Position start = squarePosition(move.from);
+        Position end = squarePosition(move.to);
+        bool valid = board.getPieceAt(start).isValidMove(start, end, board);
+        if (!valid && failures++ < 10) {
+            cout << "isValidMove rejects " << moveToString(move) << " in " << board.toFEN() << endl;
+        }
+        if (depth <= 1) {
+            nodes++;
+            continue;
+        }
+        Pieces promotion = (move.promotion != Pieces::None) ? move.promotion : Pieces::Queen;
+        if (!valid || !board.movePiece(start, end, promotion)) {
+            board.makeMove(move);
+        }
+        nodes += perftValidated(board, oppositeColor(sideToMove), depth - 1, failures);
+        board.unmakeMove();
+    }
+    return nodes;
+}
+
+// One subtree of a parallel perft: the moves from the root to its position, at most MaxSplitPly of them
+const int MaxSplitPly = 4;
+
+struct PerftTask {
+    Move path[MaxSplitPly];
+    int length = 0;
+    long long nodes = 0;
+};
+
+// Collect every position splitPly plies below the root as a task, in move generation order
+void collectTasks(Board& board, Colors sideToMove, int splitPly, PerftTask& current, vector<PerftTask>& tasks) {
+    if (current.length == splitPly) {
+        tasks.push_back(current);
+        return;
+    }
+    MoveList moves = board.generateLegalMoves(sideToMove);
+    for (const Move& move : moves) {
+        current.path[current.length++] = move;
+        board.makeMove(move);
+        collectTasks(board, oppositeColor(sideToMove), splitPly, current, tasks);
+        board.unmakeMove();
+        current.length--;
+    }
+}
+
+// Task queues of a work-stealing pool: every worker takes tasks from the back of its own queue, and when it
+// runs dry steals from the front of the others'. All tasks are queued before the workers start, so a worker
+// that finds every queue empty is done.
+class WorkStealingQueues {
+private:
+    struct Queue {
+        mutex lock;
+        deque<int> tasks;
+    };
+    unique_ptr<Queue[]> queues;
+    int queueCount;
+
+public:
+    WorkStealingQueues(int workers, int taskCount) : queues(new Queue[workers]), queueCount(workers) {
+        // Neighbouring tasks share most of their path, so each worker starts with a block of them
+        for (int task = 0; task < taskCount; task++) {
+            queues[static_cast<long long>(task) * workers / taskCount].tasks.push_back(task);
+        }
+    }
+
+    // The next task for the worker, or -1 when there is no work left
+    int next(int worker) {
+        {
+            lock_guard<mutex> guard(queues[worker].lock);
+            if (!queues[worker].tasks.empty()) {
+                int task = queues[worker].tasks.back();
+                queues[worker].tasks.pop_back();
+                return task;
+            }
+        }
+        for (int i = 1; i < queueCount; i++) {
+            Queue& victim = queues[(worker + i) % queueCount];
+            lock_guard<mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                int task = victim.tasks.front();
+                victim.tasks.pop_front();
+                return task;
+            }
+        }
+        return -1;
+    }
+};
+
+// Perft split into the subtrees splitPly plies below the root, counted by a pool of threads. Every task
+// writes its own count and the counts are summed in task order afterwards, so the result does not depend
+// on which thread counted what.
+vector<PerftTask> parallelPerft(const Board& root, int depth, int splitPly, int threads, PerftCache* cache) {
+    Board board = root;
+    PerftTask current;
+    vector<PerftTask> tasks;
+    collectTasks(board, board.getSideToMove(), splitPly, current, tasks);
+
+    // Each worker counts on its own board, built from a snapshot of the root
+    BoardSnapshot snapshot;
+    root.saveSnapshot(snapshot);
+    WorkStealingQueues queues(threads, static_cast<int>(tasks.size()));
+    vector<thread> workers;
+    for (int worker = 0; worker < threads; worker++) {
+        workers.emplace_back([&snapshot, &tasks, &queues, depth, splitPly, cache, worker]() {
+            Board workerBoard(snapshot);
+            for (int task = queues.next(worker); task >= 0; task = queues.next(worker)) {
+                PerftTask& subtree = tasks[task];
+                for (int i = 0; i < subtree.length; i++) {
+                    workerBoard.makeMove(subtree.path[i]);
+                }
+                subtree.nodes = perft(workerBoard, workerBoard.getSideToMove(), depth - splitPly, cache);
+                for (int i = 0; i < subtree.length; i++) {
+                    workerBoard.unmakeMove();
+                }
+            }
+        });
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    return tasks;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        cout << "Usage: Perft <depth> [divide] [validate] [threads <n>] [split <ply>] [hash <MB>] [compare] [fen <FEN>] [moves <move> ...]" << endl;
+        cout << "  depth    number of plies to search" << endl;
+        cout << "  divide   print the node count below each root move" << endl;
+        cout << "  validate check every move with the piece's isValidMove and play it with movePiece (serial only)" << endl;
+        cout << "  threads  count on this many threads, splitting the tree into subtrees (default 1)" << endl;
+        cout << "  split    ply below the root at which the tree is split, 1 to " << MaxSplitPly << " (default 2)" << endl;
+        cout << "  hash     cache subtree counts in a table of this many MB, so transpositions are counted once" << endl;
+        cout << "  compare  also count serially first and report the speedup" << endl;
+        cout << "  fen      start from this position instead of the starting position" << endl;
+        cout << "  moves    play these moves (e.g. e2e4 e7e5) first" << endl;
+        return 1;
+    }
+
+    int depth = atoi(argv[1]);
+    bool divide = false;
+    bool validate = false;
+    int threads = 1;
+    int splitPly = 2;
+    size_t hashMegabytes = 0;
+    bool compare = false;
+    string fen = StartFEN;
+    vector<string> playedMoves;
+    auto isKeyword = [](const string& argument) {
+        for (const char* keyword : { "divide", "validate", "threads", "split", "hash", "compare", "fen", "moves" }) {
+            if (argument == keyword) {
+                return true;
+            }
+        }
+        return false;
+    };
+    for (int i = 2; i < argc; i++) {
+        string argument = argv[i];
+        if (argument == "divide") {
+            divide = true;
+        }
+        else if (argument == "validate") {
+            validate = true;
+        }
+        else if (argument == "compare") {
+            compare = true;
+        }
+        else if ((argument == "threads" || argument == "split" || argument == "hash") && i + 1 < argc) {
+            int value = atoi(argv[++i]);
+            if (argument == "threads") {
+                threads = value;
+            }
+            else if (argument == "split") {
+                splitPly = value;
+            }
+            else {
+                hashMegabytes = static_cast<size_t>(max(value, 0));
+            }
+        }
+        else if (argument == "fen") {
+            // The FEN fields are separate arguments, up to the next keyword
+            fen.clear();
+            while (i + 1 < argc && !isKeyword(argv[i + 1])) {
+                fen += (fen.empty() ? "" : " ") + string(argv[++i]);
+            }
+        }
+        else if (argument == "moves") {
+            for (i++; i < argc; i++) {
+                playedMoves.push_back(argv[i]);
+            }
+        }
+        else {
+            cout << "Unknown argument: " << argument << endl;
+            return 1;
+        }
+    }
+    if (depth < 1) {
+        cout << "Depth must be at least 1" << endl;
+        return 1;
+    }
+    if (threads < 1 || splitPly < 1 || splitPly > MaxSplitPly) {
+        cout << "Threads must be at least 1 and split from 1 to " << MaxSplitPly << endl;
+        return 1;
+    }
+
+    // Set up the position
+    Board board;
+    if (!board.fromFEN(fen)) {
+        cout << "Invalid FEN: " << fen << endl;
+        return 1;
+    }
+    Colors sideToMove = board.getSideToMove();
+    for (const string& text : playedMoves) {
+        const Move* found = nullptr;
+        MoveList moves = board.generateLegalMoves(sideToMove);
+        for (const Move& move : moves) {
+            if (moveToString(move) == text) {
+                found = &move;
+            }
+        }
+        if (!found) {
+            cout << "Illegal move: " << text << endl;
+            return 1;
+        }
+        board.makeMove(*found);
+        sideToMove = oppositeColor(sideToMove);
+    }
+
+    // The serial count, the only one unless more threads or a cache are asked for
+    bool parallel = (threads > 1 || hashMegabytes > 0) && depth > 1 && !validate;
+    double serialSeconds = 0;
+    long long nodes = 0;
+    long long validationFailures = 0;
+    if (!parallel || compare) {
+        auto startTime = chrono::steady_clock::now();
+        if (divide) {
+            MoveList moves = board.generateLegalMoves(sideToMove);
+            for (const Move& move : moves) {
+                long long moveNodes = 1;
+                if (depth > 1) {
+                    board.makeMove(move);
+                    moveNodes = validate ? perftValidated(board, oppositeColor(sideToMove), depth - 1, validationFailures)
+                        : perft(board, oppositeColor(sideToMove), depth - 1);
+                    board.unmakeMove();
+                }
+                nodes += moveNodes;
+                cout << moveToString(move) << ": " << moveNodes << endl;
+            }
+        }
+        else {
+            nodes = validate ? perftValidated(board, sideToMove, depth, validationFailures) : perft(board, sideToMove, depth);
+        }
+        serialSeconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+    }
+
+    double seconds = serialSeconds;
+    if (parallel) {
+        long long serialNodes = nodes;
+        unique_ptr<PerftCache> cache;
+        if (hashMegabytes > 0) {
+            cache = make_unique<PerftCache>(hashMegabytes);
+        }
+        // The subtrees must have at least one ply left to count
+        splitPly = min(splitPly, depth - 1);
+
+        auto startTime = chrono::steady_clock::now();
+        vector<PerftTask> tasks = parallelPerft(board, depth, splitPly, threads, cache.get());
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+
+        nodes = 0;
+        for (const PerftTask& task : tasks) {
+            nodes += task.nodes;
+        }
+        if (divide && !compare) {
+            // Tasks are in move generation order, so the subtrees of each root move are next to each other
+            MoveList moves = board.generateLegalMoves(sideToMove);
+            size_t task = 0;
+            for (const Move& move : moves) {
+                long long moveNodes = 0;
+                for (; task < tasks.size() && tasks[task].path[0].from == move.from && tasks[task].path[0].to == move.to
+                    && tasks[task].path[0].promotion == move.promotion; task++) {
+                    moveNodes += tasks[task].nodes;
+                }
+                cout << moveToString(move) << ": " << moveNodes << endl;
+            }
+        }
+
+        cout << "Threads: " << threads << ", split at ply " << splitPly << " into " << tasks.size() << " subtrees";
+        if (cache) {
+            cout << ", " << hashMegabytes << " MB cache";
+        }
+        cout << endl;
+        if (compare) {
+            cout << "Serial time: " << serialSeconds << " s" << endl;
+            cout << "Speedup: " << (seconds > 0 ? serialSeconds / seconds : 0) << "x" << endl;
+            if (serialNodes != nodes) {
+                cout << "Mismatch: the serial count is " << serialNodes << endl;
+            }
+        }
+    }
+
+    cout << "Depth: " << depth << endl;
+    cout << "Nodes: " << nodes << endl;
+    cout << "Time: " << seconds << " s" << endl;
+    cout << "Nodes/second: " << static_cast<long long>(seconds > 0 ? nodes / seconds : 0) << endl;
+    if (validate) {
+        cout << "Moves rejected by isValidMove: " << validationFailures << endl;
+    }
+
+    // How much of the attack maps each move and take-back had to compute again
+    AttackMapStats attackStats = board.getAttackMapStats();
+    if (attackStats.updates > 0) {
+        cout << "Attack map updates: " << attackStats.updates << endl;
+        cout << "Squares recomputed/update: " << static_cast<double>(attackStats.squaresRecomputed) / attackStats.updates << endl;
+    }
+    return validationFailures > 0 ? 1 : 0;
+}
@@ -0,0 +1,93 @@
+/*
+ * File: Generator.cpp
+ * Author: Omri Shalev
+ * Date: October 16, 2026
+ * Description: Tablebase generator - writes the endgame tables of the given materials (and of every smaller
+ *              material they need) to a directory, and probes positions in the tables of a directory.
+ */
+
+#include "Classes.h"
+#include "Tablebase.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+const char* outcomeName(TablebaseOutcome outcome) {
+    switch (outcome) {
+    case TablebaseOutcome::Win: return "win";
+    case TablebaseOutcome::Loss: return "loss";
+    default: return "draw";
+    }
+}
+
+// Print the outcome of a position for the side to move
+int probeFEN(const string& directory, const string& fen) {
+    Tablebases tables;
+    int opened = tables.open(directory);
+    Board board;
+    if (!board.fromFEN(fen)) {
+        cout << "Invalid FEN " << fen << endl;
+        return 1;
+    }
+    TablebaseResult result;
+    if (!tables.probe(board, result)) {
+        cout << "No table for this position (" << opened << " tables open)" << endl;
+        return 1;
+    }
+    cout << outcomeName(result.outcome);
+    if (result.outcome != TablebaseOutcome::Draw) {
+        cout << ", mate in " << result.pliesToMate << " plies";
+    }
+    cout << endl;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cout << "Usage: TablebaseGenerator <directory> <material> [<material> ...] [threads <n>]" << endl;
+        cout << "       TablebaseGenerator <directory> probe <FEN>" << endl;
+        cout << "  material  such as KQvK or KRvKN, with at most " << MaxTablebasePieces << " pieces. The tables it needs" << endl;
+        cout << "            and that are not in the directory yet are generated first." << endl;
+        cout << "  threads   generate on this many threads (default: one per core)" << endl;
+        cout << "  probe     print whether the side to move wins, draws or loses, and the distance to mate" << endl;
+        return 1;
+    }
+    string directory = argv[1];
+    if (string(argv[2]) == "probe") {
+        // The FEN may be given as one argument or as its six fields
+        string fen;
+        for (int i = 3; i < argc; i++) {
+            fen += (i > 3 ? " " : "") + string(argv[i]);
+        }
+        return probeFEN(directory, fen);
+    }
+
+    int threads = max(static_cast<int>(thread::hardware_concurrency()), 1);
+    vector<string> materials;
+    for (int i = 2; i < argc; i++) {
+        if (string(argv[i]) == "threads" && i + 1 < argc) {
+            threads = max(atoi(argv[++i]), 1);
+        }
+        else {
+            materials.push_back(argv[i]);
+        }
+    }
+
+    Tablebases tables;
+    int opened = tables.open(directory);
+    cout << opened << " tables already in " << directory << ", generating on " << threads << " threads" << endl;
+    auto startTime = chrono::steady_clock::now();
+    for (const string& material : materials) {
+        if (!tables.generate(material, directory, threads, cout)) {
+            return 1;
+        }
+    }
+    cout << "Done in " << chrono::duration<double>(chrono::steady_clock::now() - startTime).count() << " s, "
+        << tables.tableCount() << " tables open" << endl;
+    return 0;
+}